@@ -119,7 +119,9 @@ void AMasterCharacter::BeginPlay()
 
 	if (IsValid(EquipmentComponent))
 	{
-		EquipmentComponent->OnEquipmentSlotChanged.AddDynamic(this, &AMasterCharacter::OnEquipmentSlotChanged);
+		// Одно уведомление на операцию (ApplyLoadout меняет много слотов) — одна пересборка акторов в руках
+		EquipmentComponent->OnEquipmentChangedNative.RemoveAll(this);
+		EquipmentComponent->OnEquipmentChangedNative.AddUObject(this, &AMasterCharacter::OnEquipmentChanged);
 
 		if (IsValid(EquipmentComponent))
 		{
@@ -827,15 +829,18 @@ void AMasterCharacter::OnArmsReloadMontageEnded(UAnimMontage* Montage, bool bInt
 	}
 }
 
-void AMasterCharacter::OnEquipmentSlotChanged(EEquipmentSlotId SlotId, UItemObject* Item)
+void AMasterCharacter::OnEquipmentChanged(const FEquipmentChangeSet& ChangeSet)
 {
-	// Перестраиваем визуал для слотов, которые могут быть в руках
-	if (SlotId == EEquipmentSlotId::PrimaryWeaponSlot ||
-		SlotId == EEquipmentSlotId::SecondaryWeaponSlot ||
-		SlotId == EEquipmentSlotId::PistolSlot ||
-		SlotId == EEquipmentSlotId::KnifeSlot ||
-		SlotId == EEquipmentSlotId::GrenadePrimarySlot ||
-		SlotId == EEquipmentSlotId::GrenadeSecondarySlot)
+	// Перестраиваем визуал, если сменился предмет в слоте, который может быть в руках
+	const uint32 HeldSlotsMask =
+		UEquipmentComponent::SlotBit(EEquipmentSlotId::PrimaryWeaponSlot) |
+		UEquipmentComponent::SlotBit(EEquipmentSlotId::SecondaryWeaponSlot) |
+		UEquipmentComponent::SlotBit(EEquipmentSlotId::PistolSlot) |
+		UEquipmentComponent::SlotBit(EEquipmentSlotId::KnifeSlot) |
+		UEquipmentComponent::SlotBit(EEquipmentSlotId::GrenadePrimarySlot) |
+		UEquipmentComponent::SlotBit(EEquipmentSlotId::GrenadeSecondarySlot);
+
+	if ((ChangeSet.ItemSlots & HeldSlotsMask) != 0)
 	{
 		RebuildHeldActors();
 	}
@@ -945,15 +950,15 @@ EWeaponState AMasterCharacter::DeriveWeaponStateFromItem(const UItemObject* Item
 	}
 
 	// Явный override из DataAsset (ItemDetails)
-	if (Item->ItemDetails.HandsWeaponState != EWeaponState::Unarmed)
+	if (Item->GetItemDetails().HandsWeaponState != EWeaponState::Unarmed)
 	{
-		return Item->ItemDetails.HandsWeaponState;
+		return Item->GetItemDetails().HandsWeaponState;
 	}
 
 	// Болт/гранаты
-	if (Item->ItemDetails.ItemSubCategory == EItemSubCategory::ItemSubCat_Weapons_Grenade)
+	if (Item->GetItemDetails().ItemSubCategory == EItemSubCategory::ItemSubCat_Weapons_Grenade)
 	{
-		switch (Item->ItemDetails.GrenadeType)
+		switch (Item->GetItemDetails().GrenadeType)
 		{
 		case EGrenadeType::Grenade_Bolt:
 			return EWeaponState::Grenade_Bolt;
@@ -965,21 +970,21 @@ EWeaponState AMasterCharacter::DeriveWeaponStateFromItem(const UItemObject* Item
 	}
 
 	// Нож
-	if (Item->ItemDetails.ItemSubCategory == EItemSubCategory::ItemSubCat_Weapons_Knife)
+	if (Item->GetItemDetails().ItemSubCategory == EItemSubCategory::ItemSubCat_Weapons_Knife)
 	{
 		return EWeaponState::Weapon_Knife;
 	}
 
 	// Пистолет
-	if (Item->ItemDetails.ItemSubCategory == EItemSubCategory::ItemSubCat_Weapons_HG)
+	if (Item->GetItemDetails().ItemSubCategory == EItemSubCategory::ItemSubCat_Weapons_HG)
 	{
 		return EWeaponState::Weapon_Pistol;
 	}
 
 	// Оружие
-	if (Item->ItemDetails.ItemCategory == EItemCategory::ItemCat_Weapons)
+	if (Item->GetItemDetails().ItemCategory == EItemCategory::ItemCat_Weapons)
 	{
-		switch (Item->ItemDetails.WeaponType)
+		switch (Item->GetItemDetails().WeaponType)
 		{
 		case EWeaponType::Weapon_AK12:
 		case EWeaponType::Weapon_AK74:
@@ -1001,17 +1006,17 @@ AActor* AMasterCharacter::SpawnHeldActorFromItem(UItemObject* Item)
 	if (!IsValid(W)) return nullptr;
 
 	// приоритет: HandsClass (DataAsset)
-	TSubclassOf<AActor> ClassToSpawn = Item->ItemDetails.HandsClass;
+	TSubclassOf<AActor> ClassToSpawn = Item->GetItemDetails().HandsClass;
 
 	// если не задано — пробуем ItemClass, но только если это НЕ pickup-актор
-	if (!ClassToSpawn && Item->ItemDetails.ItemClass &&
-		!Item->ItemDetails.ItemClass->IsChildOf(AMasterItemActor::StaticClass()))
+	if (!ClassToSpawn && Item->GetItemDetails().ItemClass &&
+		!Item->GetItemDetails().ItemClass->IsChildOf(AMasterItemActor::StaticClass()))
 	{
-		ClassToSpawn = Item->ItemDetails.ItemClass;
+		ClassToSpawn = Item->GetItemDetails().ItemClass;
 	}
 
 	// fallback на дефолтный WeaponActor для любого оружия
-	if (!ClassToSpawn && Item->ItemDetails.ItemCategory == EItemCategory::ItemCat_Weapons)
+	if (!ClassToSpawn && Item->GetItemDetails().ItemCategory == EItemCategory::ItemCat_Weapons)
 	{
 		ClassToSpawn = DefaultWeaponActorClass;
 	}
@@ -1036,7 +1041,7 @@ AActor* AMasterCharacter::SpawnHeldActorFromItem(UItemObject* Item)
 	// attach к сокету
 	if (IsValid(Mesh1P))
 	{
-		const FName Socket = Item->ItemDetails.HandsSocket.IsNone() ? WeaponAttachSocketName : Item->ItemDetails.HandsSocket;
+		const FName Socket = Item->GetItemDetails().HandsSocket.IsNone() ? WeaponAttachSocketName : Item->GetItemDetails().HandsSocket;
 
 		if (!Socket.IsNone() && !Mesh1P->DoesSocketExist(Socket))
 		{
@@ -1168,97 +1173,49 @@ void AMasterCharacter::PickupItem()
 
 	const bool bStackable = Asset->ItemDetails.bIsStackable;
 	const int32 MaxStack = FMath::Max(1, Asset->ItemDetails.MaxStackCount);
-	const float UnitWeight = FMath::Max(0.f, Asset->ItemDetails.ItemWeight);
-
-	bool bStackChanged = false;
+	const int64 UnitGrams = UInventoryComponent::WeightToGrams(Asset->ItemDetails.ItemWeight);
 
 	auto CalcAllowedByWeight = [&](int32 Want) -> int32
 	{
 		if (Want <= 0) return 0;
 
 		// Если веса нет или лимит отключен — не ограничиваем
-		if (UnitWeight <= KINDA_SMALL_NUMBER || InventoryComponent->GetMaxCarryWeight() <= 0.f)
+		if (UnitGrams <= 0 || InventoryComponent->GetMaxCarryWeight() <= 0.f)
 		{
 			return Want;
 		}
 
-		const float Free = InventoryComponent->GetMaxCarryWeight() - InventoryComponent->GetTotalWeight();
-		if (Free <= 0.f)
+		// Журнал веса в граммах: O(1) и без накопленной ошибки float
+		const int64 FreeGrams = UInventoryComponent::WeightToGrams(InventoryComponent->GetMaxCarryWeight()) - InventoryComponent->GetTotalWeightGrams();
+		if (FreeGrams <= 0)
 		{
 			return 0;
 		}
 
-		const int32 ByWeight = FMath::FloorToInt(Free / UnitWeight);
-		return FMath::Clamp(ByWeight, 0, Want);
+		return static_cast<int32>(FMath::Min<int64>(FreeGrams / UnitGrams, Want));
 	};
 
-	// Докидываем в существующие стаки
+	// Докидываем в существующие неполные стаки (индекс инвентаря, без обхода всех предметов)
 	if (bStackable && Remaining > 0)
 	{
-		const TArray<UItemObject*> AllItems = InventoryComponent->GetAllItems();
-		for (UItemObject* Existing : AllItems)
-		{
-			if (!IsValid(Existing) || Existing->SourceAsset != Asset || !Existing->IsStackable())
-			{
-				continue;
-			}
-
-			const int32 Curr = FMath::Max(1, Existing->Runtime.StackCount);
-			const int32 Space = FMath::Max(0, MaxStack - Curr);
-			if (Space <= 0)
-			{
-				continue;
-			}
-
-			int32 Add = FMath::Min(Remaining, Space);
-
-			// Ограничиваем по весу
-			Add = CalcAllowedByWeight(Add);
-			if (Add <= 0)
-			{
-				// веса больше нет — дальше бессмысленно
-				break;
-			}
-
-			Existing->SetStackCount(Curr + Add);
-			bStackChanged = true;
-
-			PickedUp += Add;
-			Remaining -= Add;
-
-			if (Remaining <= 0)
-			{
-				break;
-			}
-		}
-	}
-
-	if (bStackChanged)
-	{
-		InventoryComponent->MarkInventoryChanged();
+		const int32 Merged = InventoryComponent->AddToExistingStacks(Asset, CalcAllowedByWeight(Remaining));
+		PickedUp += Merged;
+		Remaining -= Merged;
 	}
 
-	// Остаток — создаём новые ItemObject и пытаемся добавить
+	// Остаток — новыми стаками по значению (UItemObject создастся, только если инвентарь на экране)
 	while (Remaining > 0)
 	{
 		int32 Chunk = bStackable ? FMath::Min(Remaining, MaxStack) : 1;
 
-		// Ограничиваем по весу (иначе TryAddItem просто вернет false и мы зря создадим объект)
+		// Ограничиваем по весу (иначе TryAddItemInstance просто вернет false)
 		Chunk = CalcAllowedByWeight(Chunk);
 		if (Chunk <= 0)
 		{
 			break;
 		}
 
-		UItemObject* NewItem = NewObject<UItemObject>(InventoryComponent);
-		if (!IsValid(NewItem))
-		{
-			break;
-		}
-
-		NewItem->InitializeFromAsset(Asset, Chunk);
-
-		if (!InventoryComponent->TryAddItem(NewItem))
+		if (!InventoryComponent->TryAddItemInstance(UItemObject::MakeAssetInstance(Asset, Chunk)))
 		{
 			// Нет места или перегруз — прекращаем (остаток остается на земле)
 			break;
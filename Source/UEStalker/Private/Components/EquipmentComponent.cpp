@@ -1,6 +1,9 @@
 #include "Components/EquipmentComponent.h"
 #include "Components/InventoryComponent.h"
+#include "Components/InventoryStateHash.h"
 #include "Items/ItemObject.h"
+#include "Items/ItemTagRegistry.h"
+#include "Items/MasterItemDataAsset.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundBase.h"
 
@@ -10,6 +13,9 @@ UEquipmentComponent::UEquipmentComponent()
 
 	Slots.SetNum(static_cast<int32>(EEquipmentSlotId::Slot_Count));
 	Blocked.SetNumZeroed(static_cast<int32>(EEquipmentSlotId::Slot_Count));
+	SlotHashTerms.SetNumZeroed(static_cast<int32>(EEquipmentSlotId::Slot_Count));
+	SlotChangedDelegates.SetNum(static_cast<int32>(EEquipmentSlotId::Slot_Count));
+	SlotStatTerms.SetNumZeroed(static_cast<int32>(EEquipmentSlotId::Slot_Count));
 }
 
 void UEquipmentComponent::BeginPlay()
@@ -22,7 +28,40 @@ void UEquipmentComponent::BeginPlay()
 		InventoryRef = OwnerActor->FindComponentByClass<UInventoryComponent>();
 	}
 
+	if (IsValid(InventoryRef))
+	{
+		InventoryRef->OnEquippedItemContentChangedNative.RemoveAll(this);
+		InventoryRef->OnEquippedItemContentChangedNative.AddUObject(this, &UEquipmentComponent::HandleEquippedItemContentChanged);
+	}
+
+	// Замки могли прийти из дефолтов Blueprint — считаем вклады всех слотов заново
+	SlotHashTerms.Init(0, Slots.Num());
+	SlotsHash = 0;
+	LockedSlotsMask = 0;
+	for (int32 i = 1; i < Slots.Num(); ++i)
+	{
+		UpdateSlotHash(i);
+		UpdateSlotStats(i);
+		if (Slots[i].bLocked)
+		{
+			LockedSlotsMask |= SlotBit(static_cast<EEquipmentSlotId>(i));
+		}
+	}
+
 	RebuildBlockedSlots();
+
+	// Начальное состояние — всем слотам одним набором (UI строится по нему)
+	FEquipmentChangeSet Initial;
+	for (int32 i = 1; i < Slots.Num(); ++i)
+	{
+		Initial.ItemSlots |= SlotBit(static_cast<EEquipmentSlotId>(i));
+		Initial.ChangedSlots.Add(static_cast<EEquipmentSlotId>(i));
+	}
+	BroadcastChangeSet(Initial);
+
+	// Бонус переноса сразу уходит в инвентарь (предметы могли быть надеты до BeginPlay)
+	RecomputeStatTotals();
+	BroadcastStatsChanged();
 }
 
 void UEquipmentComponent::SetSelectedSlot(EEquipmentSlotId SlotId)
@@ -39,7 +78,12 @@ void UEquipmentComponent::SetSelectedSlot(EEquipmentSlotId SlotId)
 	}
 
 	SelectedSlot = SlotId;
-	OnEquipmentSelectedSlotChanged.Broadcast(SelectedSlot);
+	OnEquipmentSelectedSlotChangedNative.Broadcast(SelectedSlot);
+
+	if (OnEquipmentSelectedSlotChanged.IsBound())
+	{
+		OnEquipmentSelectedSlotChanged.Broadcast(SelectedSlot);
+	}
 }
 
 bool UEquipmentComponent::EquipToSlot(EEquipmentSlotId SlotId, UItemObject* Item, bool bTryRemoveFromInventory)
@@ -65,12 +109,24 @@ bool UEquipmentComponent::EquipToSlot(EEquipmentSlotId SlotId, UItemObject* Item
 		return false;
 	}
 
+	// Один батч уведомлений на всю операцию (рассылается после коммита/отката транзакции)
+	FEquipmentChangeScope ChangeScope(this);
+
+	// Дальше несколько шагов (грид, авто-снятие шлема/рюкзака) — при неудаче откатываем всё
+	FInventoryTransactionScope Transaction(InventoryRef);
+	const TArray<UItemObject*> SlotItemsBefore = CaptureSlotItems();
+
 	// Если предмет уже был в другом слоте — снимаем оттуда (без возврата в инвентарь)
 	const EEquipmentSlotId FromSlot = FindSlotByItem(Item);
 	if (FromSlot != EEquipmentSlotId::None)
 	{
 		Slots[ToIndex(FromSlot)].Item = nullptr;
-		BroadcastChanged(FromSlot);
+		UpdateSlotHash(ToIndex(FromSlot));
+		UpdateSlotStats(ToIndex(FromSlot));
+		if (IsValid(InventoryRef))
+		{
+			InventoryRef->SetItemEquipped(Item, false);
+		}
 	}
 
 	// Если предмет лежал в инвентаре — убираем из грида
@@ -90,6 +146,7 @@ bool UEquipmentComponent::EquipToSlot(EEquipmentSlotId SlotId, UItemObject* Item
 		{
 			if (!UnequipSlot(EEquipmentSlotId::HelmetSlot, true))
 			{
+				RestoreSlotItems(SlotItemsBefore);
 				return false; // нет места, не надеваем броню
 			}
 		}
@@ -99,6 +156,7 @@ bool UEquipmentComponent::EquipToSlot(EEquipmentSlotId SlotId, UItemObject* Item
 		{
 			if (!UnequipSlot(EEquipmentSlotId::BackpackSlot, true))
 			{
+				RestoreSlotItems(SlotItemsBefore); // шлем мог уже уйти в инвентарь
 				return false;
 			}
 		}
@@ -106,16 +164,22 @@ bool UEquipmentComponent::EquipToSlot(EEquipmentSlotId SlotId, UItemObject* Item
 
 	// Положили
 	Slots[ToIndex(SlotId)].Item = Item;
+	UpdateSlotHash(ToIndex(SlotId));
+	UpdateSlotStats(ToIndex(SlotId));
 
-	// экипировка влияет на общий переносимый вес (кэш находится в InventoryComponent)
+	// экипировка влияет на общий переносимый вес (журнал находится в InventoryComponent)
 	if (IsValid(InventoryRef))
 	{
-		InventoryRef->InvalidateWeight();
+		InventoryRef->SetItemEquipped(Item, true);
 	}
 
+	// броня влияет на блокировки (слоты артефактов/модулей, внешний шлем/рюкзак)
 	if (SlotId == EEquipmentSlotId::ArmorSlot)
 	{
-		ApplyArmorModuleSlotsFromEquippedArmor();
+		ApplyArmorModuleSlotsFromEquippedArmor(); // сам пересобирает блокировки
+	}
+	else if (SlotId == EEquipmentSlotId::HelmetSlot || SlotId == EEquipmentSlotId::BackpackSlot)
+	{
 		RebuildBlockedSlots();
 	}
 
@@ -127,14 +191,7 @@ bool UEquipmentComponent::EquipToSlot(EEquipmentSlotId SlotId, UItemObject* Item
 		UGameplayStatics::PlaySoundAtLocation(this, Snd, Loc);
 	}
 
-	BroadcastChanged(SlotId);
-
-	// броня влияет на блокировки (слоты артефактов/модулей и будущую совместимость)
-	if (SlotId == EEquipmentSlotId::ArmorSlot || SlotId == EEquipmentSlotId::HelmetSlot || SlotId == EEquipmentSlotId::BackpackSlot)
-	{
-		RebuildBlockedSlots();
-	}
-
+	Transaction.Commit();
 	return true;
 }
 
@@ -151,6 +208,8 @@ bool UEquipmentComponent::UnequipSlot(EEquipmentSlotId SlotId, bool bTryReturnTo
 		return false;
 	}
 
+	FEquipmentChangeScope ChangeScope(this);
+
 	// если надо вернуть в инвентарь — пробуем положить
 	if (bTryReturnToInventory && IsValid(InventoryRef))
 	{
@@ -169,22 +228,20 @@ bool UEquipmentComponent::UnequipSlot(EEquipmentSlotId SlotId, bool bTryReturnTo
 	}
 
 	Slots[ToIndex(SlotId)].Item = nullptr;
+	UpdateSlotHash(ToIndex(SlotId));
+	UpdateSlotStats(ToIndex(SlotId));
 
 	// снятие тоже влияет на вес
 	if (IsValid(InventoryRef))
 	{
-		InventoryRef->InvalidateWeight();
+		InventoryRef->SetItemEquipped(Item, false);
 	}
 	
 	if (SlotId == EEquipmentSlotId::ArmorSlot)
 	{
-		ApplyArmorModuleSlotsFromEquippedArmor(); // это выставит 0,0,0
-		RebuildBlockedSlots();
+		ApplyArmorModuleSlotsFromEquippedArmor(); // это выставит 0,0,0 и пересоберет блокировки
 	}
-	
-	BroadcastChanged(SlotId);
-
-	if (SlotId == EEquipmentSlotId::ArmorSlot || SlotId == EEquipmentSlotId::HelmetSlot || SlotId == EEquipmentSlotId::BackpackSlot)
+	else if (SlotId == EEquipmentSlotId::HelmetSlot || SlotId == EEquipmentSlotId::BackpackSlot)
 	{
 		RebuildBlockedSlots();
 	}
@@ -218,14 +275,24 @@ void UEquipmentComponent::ActivateSlot(EEquipmentSlotId SlotId, UItemObject* Dra
 		PrevSlot = SlotId;
 	}
 
-	OnEquipmentActiveSlotChanged.Broadcast();
+	OnEquipmentActiveSlotChangedNative.Broadcast();
+
+	if (OnEquipmentActiveSlotChanged.IsBound())
+	{
+		OnEquipmentActiveSlotChanged.Broadcast();
+	}
 }
 
 void UEquipmentComponent::ClearActiveSlot()
 {
 	ActiveSlot = EEquipmentSlotId::None;
 	PrevSlot = EEquipmentSlotId::None;
-	OnEquipmentActiveSlotChanged.Broadcast();
+	OnEquipmentActiveSlotChangedNative.Broadcast();
+
+	if (OnEquipmentActiveSlotChanged.IsBound())
+	{
+		OnEquipmentActiveSlotChanged.Broadcast();
+	}
 }
 
 UItemObject* UEquipmentComponent::GetActiveItem() const
@@ -249,11 +316,7 @@ void UEquipmentComponent::SetArmorModuleSlots(int32 UnlockedSlots, int32 MaxSlot
 
 void UEquipmentComponent::RebuildBlockedSlots()
 {
-	// сброс
-	for (int32 i = 0; i < Blocked.Num(); ++i)
-	{
-		Blocked[i] = false;
-	}
+	FEquipmentChangeScope ChangeScope(this);
 
 	// --- Armor / module slots ---
 	UItemObject* Armor = GetItemInSlot(EEquipmentSlotId::ArmorSlot);
@@ -268,6 +331,18 @@ void UEquipmentComponent::RebuildBlockedSlots()
 	}
 	// если брони нет -> MaxSlots/Unlocked = 0 (все 5 закрыты)
 
+	BlockedSlotsMask = ComputeBlockedSlotsMask(Armor, MaxSlots, Unlocked);
+
+	for (int32 i = 0; i < Blocked.Num(); ++i)
+	{
+		Blocked[i] = (i > 0) && (BlockedSlotsMask & SlotBit(static_cast<EEquipmentSlotId>(i))) != 0;
+	}
+}
+
+uint32 UEquipmentComponent::ComputeBlockedSlotsMask(const UItemObject* Armor, int32 MaxSlots, int32 Unlocked) const
+{
+	uint32 Mask = 0;
+
 	const EEquipmentSlotId ItemSlots[5] =
 	{
 		EEquipmentSlotId::ItemSlot1,
@@ -279,30 +354,28 @@ void UEquipmentComponent::RebuildBlockedSlots()
 
 	for (int32 i = 0; i < 5; ++i)
 	{
-		const bool bBlocked = (i >= MaxSlots) || (i >= Unlocked);
-		Blocked[ToIndex(ItemSlots[i])] = bBlocked;
+		if ((i >= MaxSlots) || (i >= Unlocked))
+		{
+			Mask |= SlotBit(ItemSlots[i]);
+		}
 	}
 
 	// --- Armor blocks external helmet/backpack ---
 	if (IsValid(Armor))
 	{
-		const FItemOutfitStatsConfig& ACfg = Armor->OutfitStatsConfig;
+		const FItemOutfitStatsConfig& ACfg = Armor->GetOutfitStatsConfig();
 
 		if (!ACfg.bAllowExternalHelmet)
 		{
-			Blocked[ToIndex(EEquipmentSlotId::HelmetSlot)] = true;
+			Mask |= SlotBit(EEquipmentSlotId::HelmetSlot);
 		}
 		if (!ACfg.bAllowExternalBackpack)
 		{
-			Blocked[ToIndex(EEquipmentSlotId::BackpackSlot)] = true;
+			Mask |= SlotBit(EEquipmentSlotId::BackpackSlot);
 		}
 	}
 
-	// UI refresh
-	for (int32 i = 1; i < static_cast<int32>(EEquipmentSlotId::Slot_Count); ++i)
-	{
-		BroadcastChanged(static_cast<EEquipmentSlotId>(i));
-	}
+	return Mask;
 }
 
 bool UEquipmentComponent::IsSlotLocked(EEquipmentSlotId SlotId) const
@@ -330,89 +403,98 @@ bool UEquipmentComponent::CanEquipItemToSlot(UItemObject* Item, EEquipmentSlotId
 		return false;
 	}
 
-	if (IsSlotLocked(SlotId) || IsSlotBlocked(SlotId))
+	return (GetEquippableSlotMask(Item) & SlotBit(SlotId)) != 0;
+}
+
+uint32 UEquipmentComponent::ComputeStaticSlotMask(EItemCategory Category, EItemSubCategory SubCategory)
+{
+	uint32 Mask = 0;
+
+	// Outfit
+	if (Category == EItemCategory::ItemCat_Armor)    Mask |= SlotBit(EEquipmentSlotId::ArmorSlot);
+	if (Category == EItemCategory::ItemCat_Helmet)   Mask |= SlotBit(EEquipmentSlotId::HelmetSlot);
+	if (Category == EItemCategory::ItemCat_Backpack) Mask |= SlotBit(EEquipmentSlotId::BackpackSlot);
+
+	// Weapons
+	if (Category == EItemCategory::ItemCat_Weapons && IsPrimarySecondaryWeaponSubCat(SubCategory))
 	{
-		return false;
+		Mask |= SlotBit(EEquipmentSlotId::PrimaryWeaponSlot) | SlotBit(EEquipmentSlotId::SecondaryWeaponSlot);
 	}
+	if (SubCategory == EItemSubCategory::ItemSubCat_Weapons_HG)    Mask |= SlotBit(EEquipmentSlotId::PistolSlot);
+	if (SubCategory == EItemSubCategory::ItemSubCat_Weapons_Knife) Mask |= SlotBit(EEquipmentSlotId::KnifeSlot);
 
-	const EItemCategory Cat = Item->ItemDetails.ItemCategory;
-	const EItemSubCategory Sub = Item->ItemDetails.ItemSubCategory;
+	// Devices
+	if (Category == EItemCategory::ItemCat_UsableItems)
+	{
+		Mask |= SlotBit(EEquipmentSlotId::DeviceSlot1) | SlotBit(EEquipmentSlotId::DeviceSlot2) | SlotBit(EEquipmentSlotId::DeviceSlot3);
+	}
 
-	switch (SlotId)
+	// Grenades
+	if (SubCategory == EItemSubCategory::ItemSubCat_Weapons_Grenade)
 	{
-		// Outfit
-		case EEquipmentSlotId::ArmorSlot:
-			return Cat == EItemCategory::ItemCat_Armor;
+		Mask |= SlotBit(EEquipmentSlotId::GrenadePrimarySlot) | SlotBit(EEquipmentSlotId::GrenadeSecondarySlot);
+	}
 
-		case EEquipmentSlotId::HelmetSlot:
-		{
-			if (Cat != EItemCategory::ItemCat_Helmet) return false;
+	// Modules / Artefacts
+	if (SubCategory == EItemSubCategory::ItemSubCat_Items_Artefacts || SubCategory == EItemSubCategory::ItemSubCat_Items_Modules)
+	{
+		Mask |= SlotBit(EEquipmentSlotId::ItemSlot1) | SlotBit(EEquipmentSlotId::ItemSlot2) | SlotBit(EEquipmentSlotId::ItemSlot3)
+			| SlotBit(EEquipmentSlotId::ItemSlot4) | SlotBit(EEquipmentSlotId::ItemSlot5);
+	}
 
-			UItemObject* Armor = GetItemInSlot(EEquipmentSlotId::ArmorSlot);
-			if (IsValid(Armor))
-			{
-				return IsHelmetCompatibleWithArmor(Item, Armor);
-			}
-			return true;
-		}
+	// Quick access
+	if (SubCategory == EItemSubCategory::ItemSubCat_Items_Food ||
+		SubCategory == EItemSubCategory::ItemSubCat_Items_Water ||
+		SubCategory == EItemSubCategory::ItemSubCat_Items_Medicine)
+	{
+		Mask |= SlotBit(EEquipmentSlotId::QuickSlot1) | SlotBit(EEquipmentSlotId::QuickSlot2)
+			| SlotBit(EEquipmentSlotId::QuickSlot3) | SlotBit(EEquipmentSlotId::QuickSlot4);
+	}
 
-		case EEquipmentSlotId::BackpackSlot:
-		{
-			if (Cat != EItemCategory::ItemCat_Backpack) return false;
+	return Mask;
+}
+
+uint32 UEquipmentComponent::GetEquippableSlotMask(const UItemObject* Item) const
+{
+	if (!IsValid(Item))
+	{
+		return 0;
+	}
+
+	uint32 Mask = Item->GetEquipSlotMask() & ~(LockedSlotsMask | BlockedSlotsMask);
 
-			UItemObject* Armor = GetItemInSlot(EEquipmentSlotId::ArmorSlot);
-			if (IsValid(Armor))
+	// Шлем/рюкзак дополнительно проверяем против надетой брони
+	const uint32 ArmorDependent = SlotBit(EEquipmentSlotId::HelmetSlot) | SlotBit(EEquipmentSlotId::BackpackSlot);
+	if (Mask & ArmorDependent)
+	{
+		if (const UItemObject* Armor = GetItemInSlot(EEquipmentSlotId::ArmorSlot))
+		{
+			if ((Mask & SlotBit(EEquipmentSlotId::HelmetSlot)) && !IsHelmetCompatibleWithArmor(Item, Armor))
+			{
+				Mask &= ~SlotBit(EEquipmentSlotId::HelmetSlot);
+			}
+			if ((Mask & SlotBit(EEquipmentSlotId::BackpackSlot)) && !IsBackpackCompatibleWithArmor(Item, Armor))
 			{
-				return IsBackpackCompatibleWithArmor(Item, Armor);
+				Mask &= ~SlotBit(EEquipmentSlotId::BackpackSlot);
 			}
-			return true;
 		}
+	}
 
-		// Weapons
-		case EEquipmentSlotId::PrimaryWeaponSlot:
-		case EEquipmentSlotId::SecondaryWeaponSlot:
-			return (Cat == EItemCategory::ItemCat_Weapons) && IsPrimarySecondaryWeaponSubCat(Sub);
-
-		case EEquipmentSlotId::PistolSlot:
-			return Sub == EItemSubCategory::ItemSubCat_Weapons_HG;
-
-		case EEquipmentSlotId::KnifeSlot:
-			return Sub == EItemSubCategory::ItemSubCat_Weapons_Knife;
-
-		// Devices
-		case EEquipmentSlotId::DeviceSlot1:
-		case EEquipmentSlotId::DeviceSlot2:
-		case EEquipmentSlotId::DeviceSlot3:
-			return Cat == EItemCategory::ItemCat_UsableItems;
-
-		// Grenades
-		case EEquipmentSlotId::GrenadePrimarySlot:
-		case EEquipmentSlotId::GrenadeSecondarySlot:
-			return Sub == EItemSubCategory::ItemSubCat_Weapons_Grenade;
-
-		// Modules / Artefacts
-		case EEquipmentSlotId::ItemSlot1:
-		case EEquipmentSlotId::ItemSlot2:
-		case EEquipmentSlotId::ItemSlot3:
-		case EEquipmentSlotId::ItemSlot4:
-		case EEquipmentSlotId::ItemSlot5:
-			return (Sub == EItemSubCategory::ItemSubCat_Items_Artefacts ||
-					Sub == EItemSubCategory::ItemSubCat_Items_Modules);
+	return Mask;
+}
 
-		// Quick access
-		case EEquipmentSlotId::QuickSlot1:
-		case EEquipmentSlotId::QuickSlot2:
-		case EEquipmentSlotId::QuickSlot3:
-		case EEquipmentSlotId::QuickSlot4:
-			return (Sub == EItemSubCategory::ItemSubCat_Items_Food ||
-					Sub == EItemSubCategory::ItemSubCat_Items_Water ||
-					Sub == EItemSubCategory::ItemSubCat_Items_Medicine);
+TArray<EEquipmentSlotId> UEquipmentComponent::K2_GetEquippableSlots(UItemObject* Item) const
+{
+	TArray<EEquipmentSlotId> Result;
 
-		default:
-			break;
+	uint32 Mask = GetEquippableSlotMask(Item);
+	while (Mask != 0)
+	{
+		Result.Add(static_cast<EEquipmentSlotId>(FMath::CountTrailingZeros(Mask)));
+		Mask &= Mask - 1u;
 	}
 
-	return false;
+	return Result;
 }
 
 void UEquipmentComponent::SetSlotLocked(EEquipmentSlotId SlotId, bool bLocked)
@@ -421,8 +503,18 @@ void UEquipmentComponent::SetSlotLocked(EEquipmentSlotId SlotId, bool bLocked)
 	{
 		return;
 	}
+	FEquipmentChangeScope ChangeScope(this);
+
 	Slots[ToIndex(SlotId)].bLocked = bLocked;
-	BroadcastChanged(SlotId);
+	if (bLocked)
+	{
+		LockedSlotsMask |= SlotBit(SlotId);
+	}
+	else
+	{
+		LockedSlotsMask &= ~SlotBit(SlotId);
+	}
+	UpdateSlotHash(ToIndex(SlotId));
 }
 
 UItemObject* UEquipmentComponent::GetItemInSlot(EEquipmentSlotId SlotId) const
@@ -483,7 +575,7 @@ bool UEquipmentComponent::RemoveFromInventoryIfPresent(UItemObject* Item) const
 	}
 
 	// если предмет лежит в гриде — удаляем оттуда перед экипировкой
-	if (InventoryRef->Items.Contains(Item))
+	if (InventoryRef->ContainsItem(Item))
 	{
 		InventoryRef->RemoveItem(Item);
 		return true;
@@ -505,92 +597,636 @@ bool UEquipmentComponent::IsPrimarySecondaryWeaponSubCat(EItemSubCategory SubCat
 			&& SubCat != EItemSubCategory::ItemSubCat_Weapons_Grenade;
 }
 
-void UEquipmentComponent::BroadcastChanged(EEquipmentSlotId SlotId)
+void UEquipmentComponent::BroadcastChangeSet(const FEquipmentChangeSet& ChangeSet)
+{
+	// Поштучные события — только по реально измененным слотам
+	for (const EEquipmentSlotId SlotId : ChangeSet.ChangedSlots)
+	{
+		UItemObject* Item = GetItemInSlot(SlotId);
+		SlotChangedDelegates[ToIndex(SlotId)].Broadcast(SlotId, Item);
+		OnEquipmentSlotChangedNative.Broadcast(SlotId, Item);
+
+		// Динамический делегат (ProcessEvent) — только при живых Blueprint-подписчиках
+		if (OnEquipmentSlotChanged.IsBound())
+		{
+			OnEquipmentSlotChanged.Broadcast(SlotId, Item);
+		}
+	}
+
+	OnEquipmentChangedNative.Broadcast(ChangeSet);
+
+	if (OnEquipmentChanged.IsBound())
+	{
+		OnEquipmentChanged.Broadcast(ChangeSet);
+	}
+}
+
+
+void UEquipmentComponent::BroadcastStatsChanged()
+{
+	OnEquipmentStatsChangedNative.Broadcast();
+
+	if (OnEquipmentStatsChanged.IsBound())
+	{
+		OnEquipmentStatsChanged.Broadcast();
+	}
+}
+
+FOnEquipmentSlotChangedNative& UEquipmentComponent::OnSlotChangedNative(EEquipmentSlotId SlotId)
 {
-	OnEquipmentSlotChanged.Broadcast(SlotId, GetItemInSlot(SlotId));
+	// Невалидный слот — заглушка None (никогда не рассылается)
+	return SlotChangedDelegates[IsValidSlot(SlotId) ? ToIndex(SlotId) : 0];
 }
 
-bool UEquipmentComponent::HasAnyTag(const TArray<FName>& ItemTags, const TArray<FName>& QueryTags)
+void UEquipmentComponent::RemoveSlotListeners(const void* UserObject)
 {
-	if (ItemTags.Num() == 0 || QueryTags.Num() == 0) return false;
+	for (FOnEquipmentSlotChangedNative& Delegate : SlotChangedDelegates)
+	{
+		Delegate.RemoveAll(UserObject);
+	}
+}
+
+void UEquipmentComponent::BeginChangeBatch()
+{
+	if (ChangeBatchDepth++ > 0)
+	{
+		return;
+	}
+
+	BatchItemsBefore = CaptureSlotItems();
+	BatchLockedBefore = LockedSlotsMask;
+	BatchBlockedBefore = BlockedSlotsMask;
+}
+
+void UEquipmentComponent::EndChangeBatch()
+{
+	if (!ensure(ChangeBatchDepth > 0) || --ChangeBatchDepth > 0)
+	{
+		return;
+	}
 
-	for (const FName& Q : QueryTags)
+	// Сравниваем со снимком: промежуточные шаги (снял/надел обратно, тройная пересборка блокировок) не видны
+	FEquipmentChangeSet ChangeSet;
+	for (int32 i = 1; i < Slots.Num() && i < BatchItemsBefore.Num(); ++i)
 	{
-		if (ItemTags.Contains(Q))
+		if (Slots[i].Item != BatchItemsBefore[i])
 		{
-			return true;
+			ChangeSet.ItemSlots |= SlotBit(static_cast<EEquipmentSlotId>(i));
 		}
 	}
-	return false;
+	ChangeSet.LockedSlots = LockedSlotsMask ^ BatchLockedBefore;
+	ChangeSet.BlockedSlots = BlockedSlotsMask ^ BatchBlockedBefore;
+
+	BatchItemsBefore.Reset();
+
+	// Статы — только если сменился вклад слота или блокировка слота артефакта
+	const bool bStatsChanged = (bStatTermsDirty || (ChangeSet.BlockedSlots & GetStatSlotMask()) != 0) && RecomputeStatTotals();
+
+	if (!ChangeSet.IsEmpty())
+	{
+		uint32 Mask = ChangeSet.GetChangedMask();
+		while (Mask != 0)
+		{
+			ChangeSet.ChangedSlots.Add(static_cast<EEquipmentSlotId>(FMath::CountTrailingZeros(Mask)));
+			Mask &= Mask - 1u;
+		}
+
+		BroadcastChangeSet(ChangeSet);
+	}
+
+	if (bStatsChanged)
+	{
+		BroadcastStatsChanged();
+	}
 }
 
-bool UEquipmentComponent::IsAllowedByLists(const UItemObject* Candidate, const TArray<int32>& AllowedIDs,
-	const TArray<int32>& BlockedIDs, const TArray<FName>& AllowedTags, const TArray<FName>& BlockedTags)
+
+void UEquipmentComponent::UpdateSlotHash(int32 Index)
 {
-	if (!IsValid(Candidate)) return false;
+	if (!Slots.IsValidIndex(Index) || !SlotHashTerms.IsValidIndex(Index))
+	{
+		return;
+	}
 
-	const int32 Id = Candidate->ItemDetails.ItemID;
-	const TArray<FName>& Tags = Candidate->ItemDetails.ItemTags;
+	// Слот + ассет + содержимое (патроны в руках меняются без ведома слота — инвентарь зовет
+	// HandleEquippedItemContentChanged). Два одинаковых предмета в разных слотах дают разные вклады
+	const FEquipmentSlotState& SlotState = Slots[Index];
+	uint64 Term = 0;
+	if (IsValid(SlotState.Item) || SlotState.bLocked)
+	{
+		const UMasterItemDataAsset* Asset = IsValid(SlotState.Item) ? SlotState.Item->SourceAsset.Get() : nullptr;
+		Term = FInventoryStateHash::Combine(FInventoryStateHash::Mix(FInventoryStateHash::HashAsset(Asset)),
+			(static_cast<uint64>(Index) << 1) | (SlotState.bLocked ? 1ull : 0ull));
+		if (IsValid(SlotState.Item))
+		{
+			Term = FInventoryStateHash::Combine(Term, FInventoryStateHash::HashItem(SlotState.Item));
+		}
+	}
 
-	// hard-block
-	if (BlockedIDs.Contains(Id))
+	SlotsHash ^= SlotHashTerms[Index] ^ Term;
+	SlotHashTerms[Index] = Term;
+}
+
+void UEquipmentComponent::HandleEquippedItemContentChanged(const UItemObject* Item)
+{
+	const EEquipmentSlotId SlotId = FindSlotByItem(Item);
+	if (SlotId != EEquipmentSlotId::None)
 	{
-		return false;
+		UpdateSlotHash(ToIndex(SlotId));
 	}
-	if (BlockedTags.Num() > 0 && HasAnyTag(Tags, BlockedTags))
+}
+
+uint32 UEquipmentComponent::GetStatSlotMask()
+{
+	return SlotBit(EEquipmentSlotId::HelmetSlot) | SlotBit(EEquipmentSlotId::ArmorSlot) | SlotBit(EEquipmentSlotId::BackpackSlot)
+		| SlotBit(EEquipmentSlotId::ItemSlot1) | SlotBit(EEquipmentSlotId::ItemSlot2) | SlotBit(EEquipmentSlotId::ItemSlot3)
+		| SlotBit(EEquipmentSlotId::ItemSlot4) | SlotBit(EEquipmentSlotId::ItemSlot5);
+}
+
+void UEquipmentComponent::UpdateSlotStats(int32 Index)
+{
+	if (!Slots.IsValidIndex(Index) || !SlotStatTerms.IsValidIndex(Index))
 	{
-		return false;
+		return;
 	}
 
-	// allow-list (если задана — нужно пройти)
-	if (AllowedIDs.Num() > 0 && !AllowedIDs.Contains(Id))
+	const UItemObject* Item = Slots[Index].Item;
+	const bool bStatSlot = (GetStatSlotMask() & SlotBit(static_cast<EEquipmentSlotId>(Index))) != 0;
+
+	const FEquipmentStatVector Term = (bStatSlot && IsValid(Item))
+		? FEquipmentStatVector::FromOutfit(Item->GetOutfitStatsConfig())
+		: FEquipmentStatVector();
+
+	if (Term != SlotStatTerms[Index])
+	{
+		SlotStatTerms[Index] = Term;
+		bStatTermsDirty = true;
+	}
+}
+
+bool UEquipmentComponent::RecomputeStatTotals()
+{
+	bStatTermsDirty = false;
+
+	// Закрытые бронёй слоты артефактов не работают, даже если предмет в них остался
+	FEquipmentStatVector NewTotals;
+	FEquipmentStatVector::SumMasked(SlotStatTerms.GetData(), SlotStatTerms.Num(), GetStatSlotMask() & ~BlockedSlotsMask, NewTotals);
+
+	if (IsValid(InventoryRef))
+	{
+		InventoryRef->SetCarryBonusWeight(NewTotals.Get(EEquipmentStatChannel::CarryBonus));
+	}
+
+	if (NewTotals == StatTotals)
 	{
 		return false;
 	}
-	if (AllowedTags.Num() > 0 && !HasAnyTag(Tags, AllowedTags))
+
+	StatTotals = NewTotals;
+	return true;
+}
+
+void UEquipmentComponent::RefreshSlotStats(EEquipmentSlotId SlotId)
+{
+	if (!IsValidSlot(SlotId))
+	{
+		return;
+	}
+
+	FEquipmentChangeScope ChangeScope(this);
+	UpdateSlotStats(ToIndex(SlotId));
+}
+
+void UEquipmentComponent::RefreshItemStats(const UItemObject* Item)
+{
+	const EEquipmentSlotId SlotId = FindSlotByItem(Item);
+	if (SlotId != EEquipmentSlotId::None)
+	{
+		RefreshSlotStats(SlotId);
+	}
+}
+
+// ===== Loadouts =====
+
+const FEquipmentLoadout* UEquipmentComponent::FindLoadout(FName Name) const
+{
+	return Loadouts.FindByPredicate([Name](const FEquipmentLoadout& Loadout) { return Loadout.Name == Name; });
+}
+
+void UEquipmentComponent::SaveLoadout(FName Name)
+{
+	if (Name.IsNone())
+	{
+		return;
+	}
+
+	FEquipmentLoadout Loadout;
+	Loadout.Name = Name;
+
+	for (int32 i = 1; i < Slots.Num(); ++i) // skip None
+	{
+		// Запертые слоты пресет не трогает
+		if (Slots[i].bLocked)
+		{
+			continue;
+		}
+
+		FEquipmentLoadoutSlot& Entry = Loadout.Slots.AddDefaulted_GetRef();
+		Entry.SlotId = static_cast<EEquipmentSlotId>(i);
+		Entry.Item = Slots[i].Item;
+		Entry.Asset = IsValid(Slots[i].Item) ? Slots[i].Item->SourceAsset : nullptr;
+	}
+
+	const int32 Existing = Loadouts.IndexOfByPredicate([Name](const FEquipmentLoadout& L) { return L.Name == Name; });
+	if (Existing != INDEX_NONE)
+	{
+		Loadouts[Existing] = MoveTemp(Loadout);
+	}
+	else
+	{
+		Loadouts.Add(MoveTemp(Loadout));
+	}
+}
+
+bool UEquipmentComponent::RemoveLoadout(FName Name)
+{
+	return Loadouts.RemoveAll([Name](const FEquipmentLoadout& Loadout) { return Loadout.Name == Name; }) > 0;
+}
+
+UItemObject* UEquipmentComponent::ResolveLoadoutItem(const FEquipmentLoadoutSlot& Entry, const TSet<const UItemObject*>& Taken) const
+{
+	const UMasterItemDataAsset* Asset = Entry.Asset.Get();
+	if (!IsValid(Asset))
+	{
+		return nullptr;
+	}
+
+	// Кандидат должен быть тем же ассетом и подходить к слоту
+	const uint32 SlotMask = SlotBit(Entry.SlotId);
+	auto Matches = [Asset, SlotMask, &Taken](const UItemObject* Candidate)
+	{
+		return IsValid(Candidate) && Candidate->SourceAsset == Asset
+			&& (Candidate->GetEquipSlotMask() & SlotMask) != 0 && !Taken.Contains(Candidate);
+	};
+
+	// Тот же предмет — если он все еще у нас (надет или в гриде).
+	// Слабой ссылке одной не верим: пул (UItemObjectPoolSubsystem) переиспользует объект под другой предмет
+	UItemObject* Item = Entry.Item.Get();
+	if (Matches(Item)
+		&& (FindSlotByItem(Item) != EEquipmentSlotId::None || (IsValid(InventoryRef) && InventoryRef->ContainsItem(Item))))
+	{
+		return Item;
+	}
+
+	// Такой же ассет уже в этом слоте — ничего не меняем
+	UItemObject* Current = GetItemInSlot(Entry.SlotId);
+	if (Matches(Current))
+	{
+		return Current;
+	}
+
+	// Иначе — любой такой же из грида (индекс категории, без прохода по гриду)
+	if (IsValid(InventoryRef))
+	{
+		if (const TArray<UItemObject*>* Candidates = InventoryRef->GetItemIndex().FindCategory(Asset->ItemDetails.ItemCategory))
+		{
+			for (UItemObject* Candidate : *Candidates)
+			{
+				if (Matches(Candidate))
+				{
+					return Candidate;
+				}
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+bool UEquipmentComponent::ApplyLoadout(FName Name, int32& OutSkippedSlots)
+{
+	OutSkippedSlots = 0;
+
+	const FEquipmentLoadout* Loadout = FindLoadout(Name);
+	if (!Loadout)
 	{
 		return false;
 	}
 
+	// ===== 1) План: итоговый предмет каждого слота (без промежуточных состояний) =====
+	const TArray<UItemObject*> SlotItemsBefore = CaptureSlotItems();
+	TArray<UItemObject*> Target = SlotItemsBefore;
+	TArray<bool> Wanted; // слот получил предмет из пресета
+	Wanted.SetNumZeroed(Slots.Num());
+
+	TSet<const UItemObject*> Taken;
+
+	for (const FEquipmentLoadoutSlot& Entry : Loadout->Slots)
+	{
+		if (!IsValidSlot(Entry.SlotId))
+		{
+			continue;
+		}
+
+		const int32 Index = ToIndex(Entry.SlotId);
+		if (Slots[Index].bLocked)
+		{
+			++OutSkippedSlots;
+			continue;
+		}
+
+		// Пустой слот в пресете (предмет без ассета — тоже пустой: сверять не с чем)
+		if (!IsValid(Entry.Asset))
+		{
+			Target[Index] = nullptr;
+			continue;
+		}
+
+		UItemObject* Item = ResolveLoadoutItem(Entry, Taken);
+		if (!IsValid(Item))
+		{
+			++OutSkippedSlots; // такого предмета больше нет — слот как был
+			continue;
+		}
+
+		Target[Index] = Item;
+		Wanted[Index] = true;
+		Taken.Add(Item);
+	}
+
+	// Итоговая броня решает за шлем/рюкзак и слоты артефактов — порядок надевания не важен
+	const int32 ArmorIdx = ToIndex(EEquipmentSlotId::ArmorSlot);
+	const UItemObject* FinalArmor = Target[ArmorIdx];
+
+	int32 MaxSlots = 0;
+	int32 Unlocked = 0;
+	if (IsValid(FinalArmor))
+	{
+		if (FinalArmor == SlotItemsBefore[ArmorIdx])
+		{
+			MaxSlots = FMath::Clamp(ArmorModuleSlotsMax, 0, 5);
+			Unlocked = FMath::Clamp(ArmorModuleSlotsUnlocked, 0, MaxSlots);
+		}
+		else
+		{
+			const FItemOutfitStatsConfig& ACfg = FinalArmor->GetOutfitStatsConfig();
+			MaxSlots = FMath::Clamp(ACfg.MaxModuleSlots, 0, 5);
+			Unlocked = FMath::Clamp(ACfg.UnlockedModuleSlots, 0, MaxSlots);
+		}
+	}
+	const uint32 FinalBlocked = ComputeBlockedSlotsMask(FinalArmor, MaxSlots, Unlocked);
+
+	// Шлем/рюкзак, несовместимые с итоговой броней, снимаются (даже если пресет их не трогал)
+	const int32 HelmetIdx = ToIndex(EEquipmentSlotId::HelmetSlot);
+	const int32 BackpackIdx = ToIndex(EEquipmentSlotId::BackpackSlot);
+
+	if (IsValid(Target[HelmetIdx]) && !IsHelmetCompatibleWithArmor(Target[HelmetIdx], FinalArmor))
+	{
+		OutSkippedSlots += Wanted[HelmetIdx] ? 1 : 0;
+		Target[HelmetIdx] = nullptr;
+	}
+	if (IsValid(Target[BackpackIdx]) && !IsBackpackCompatibleWithArmor(Target[BackpackIdx], FinalArmor))
+	{
+		OutSkippedSlots += Wanted[BackpackIdx] ? 1 : 0;
+		Target[BackpackIdx] = nullptr;
+	}
+
+	// В закрытые итоговой броней слоты артефактов новое не кладем
+	for (int32 i = 1; i < Target.Num(); ++i)
+	{
+		if (Wanted[i] && (FinalBlocked & SlotBit(static_cast<EEquipmentSlotId>(i))) != 0 && Target[i] != SlotItemsBefore[i])
+		{
+			++OutSkippedSlots;
+			Target[i] = SlotItemsBefore[i];
+		}
+	}
+
+	// Предмет, переехавший в другой слот, из старого слота уходит
+	TSet<const UItemObject*> Placed;
+	for (int32 i = 1; i < Target.Num(); ++i)
+	{
+		if (IsValid(Target[i]) && Target[i] != SlotItemsBefore[i])
+		{
+			Placed.Add(Target[i]);
+		}
+	}
+	for (int32 i = 1; i < Target.Num(); ++i)
+	{
+		if (IsValid(Target[i]) && Target[i] == SlotItemsBefore[i] && Placed.Contains(Target[i]))
+		{
+			Target[i] = nullptr;
+		}
+	}
+
+	if (Target == SlotItemsBefore)
+	{
+		return true;
+	}
+
+	// ===== 2) Применение: один батч уведомлений и одна транзакция инвентаря =====
+	FEquipmentChangeScope ChangeScope(this);
+	FInventoryTransactionScope Transaction(InventoryRef);
+
+	// Сначала забираем новое из грида — освобождает место под снятое
+	for (UItemObject* Item : Target)
+	{
+		if (IsValid(Item) && FindSlotByItem(Item) == EEquipmentSlotId::None)
+		{
+			RemoveFromInventoryIfPresent(Item);
+		}
+	}
+
+	TSet<const UItemObject*> Final;
+	for (UItemObject* Item : Target)
+	{
+		if (IsValid(Item))
+		{
+			Final.Add(Item);
+		}
+	}
+
+	// Снимаем всё, что уходит со своего слота; в инвентарь — только то, чего нет в итоге
+	TArray<UItemObject*> Displaced;
+	for (int32 i = 1; i < Slots.Num(); ++i)
+	{
+		UItemObject* Current = Slots[i].Item;
+		if (!IsValid(Current) || Current == Target[i])
+		{
+			continue;
+		}
+
+		Slots[i].Item = nullptr;
+		UpdateSlotHash(i);
+		UpdateSlotStats(i);
+
+		if (!Final.Contains(Current))
+		{
+			if (IsValid(InventoryRef))
+			{
+				InventoryRef->SetItemEquipped(Current, false);
+			}
+			Displaced.Add(Current);
+		}
+	}
+
+	// Крупные вперед — мелочь не займет место, куда встала бы броня
+	if (IsValid(InventoryRef))
+	{
+		Displaced.Sort([](const UItemObject& A, const UItemObject& B)
+		{
+			const FItemSize& SizeA = A.GetItemDetails().Size;
+			const FItemSize& SizeB = B.GetItemDetails().Size;
+			return SizeA.X * SizeA.Y > SizeB.X * SizeB.Y;
+		});
+
+		for (UItemObject* Item : Displaced)
+		{
+			if (!InventoryRef->TryAddItem(Item))
+			{
+				RestoreSlotItems(SlotItemsBefore); // грид откатит транзакция
+				return false;
+			}
+		}
+	}
+
+	// Надеваем
+	USoundBase* EquipSound = nullptr;
+	for (int32 i = 1; i < Slots.Num(); ++i)
+	{
+		UItemObject* Item = Target[i];
+		if (Slots[i].Item == Item)
+		{
+			continue;
+		}
+
+		Slots[i].Item = Item;
+		UpdateSlotHash(i);
+		UpdateSlotStats(i);
+
+		if (IsValid(Item))
+		{
+			if (IsValid(InventoryRef))
+			{
+				InventoryRef->SetItemEquipped(Item, true);
+			}
+			if (!EquipSound)
+			{
+				EquipSound = Item->GetEquipmentSound();
+			}
+		}
+	}
+
+	// Блокировки — один раз по итоговой броне
+	if (Target[ArmorIdx] != SlotItemsBefore[ArmorIdx])
+	{
+		ApplyArmorModuleSlotsFromEquippedArmor();
+	}
+	else
+	{
+		RebuildBlockedSlots();
+	}
+
+	// Один звук на весь набор
+	if (EquipSound)
+	{
+		AActor* OwnerActor = GetOwner();
+		const FVector Loc = IsValid(OwnerActor) ? OwnerActor->GetActorLocation() : FVector::ZeroVector;
+		UGameplayStatics::PlaySoundAtLocation(this, EquipSound, Loc);
+	}
+
+	Transaction.Commit();
 	return true;
 }
 
+uint64 UEquipmentComponent::GetContentHash() const
+{
+	return SlotsHash;
+}
+
+
+TArray<UItemObject*> UEquipmentComponent::CaptureSlotItems() const
+{
+	TArray<UItemObject*> Out;
+	Out.Reserve(Slots.Num());
+
+	for (const FEquipmentSlotState& SlotState : Slots)
+	{
+		Out.Add(SlotState.Item);
+	}
+
+	return Out;
+}
+
+void UEquipmentComponent::RestoreSlotItems(const TArray<UItemObject*>& SlotItems)
+{
+	FEquipmentChangeScope ChangeScope(this);
+
+	bool bArmorChanged = false;
+
+	for (int32 i = 1; i < Slots.Num() && i < SlotItems.Num(); ++i) // skip None
+	{
+		UItemObject* Before = SlotItems[i];
+		UItemObject* Current = Slots[i].Item;
+		if (Current == Before)
+		{
+			continue;
+		}
+
+		Slots[i].Item = Before;
+		UpdateSlotHash(i);
+		UpdateSlotStats(i);
+
+		if (IsValid(InventoryRef))
+		{
+			if (IsValid(Current))
+			{
+				InventoryRef->SetItemEquipped(Current, false);
+			}
+			if (IsValid(Before))
+			{
+				InventoryRef->SetItemEquipped(Before, true);
+			}
+		}
+
+		const EEquipmentSlotId SlotId = static_cast<EEquipmentSlotId>(i);
+		bArmorChanged |= (SlotId == EEquipmentSlotId::ArmorSlot);
+	}
+
+	if (bArmorChanged)
+	{
+		ApplyArmorModuleSlotsFromEquippedArmor();
+	}
+
+	RebuildBlockedSlots();
+}
+
 bool UEquipmentComponent::IsHelmetCompatibleWithArmor(const UItemObject* Helmet, const UItemObject* Armor) const
 {
 	if (!IsValid(Helmet) || !IsValid(Armor)) return true;
 
-	const FItemOutfitStatsConfig& ACfg = Armor->OutfitStatsConfig;
-
-	if (!ACfg.bAllowExternalHelmet)
+	if (!Armor->GetOutfitStatsConfig().bAllowExternalHelmet)
 	{
 		return false;
 	}
 
-	return IsAllowedByLists(
-		Helmet,
-		ACfg.AllowedHelmetItemIDs,
-		ACfg.BlockedHelmetItemIDs,
-		ACfg.AllowedHelmetTags,
-		ACfg.BlockedHelmetTags);
+	// Списки скомпилированы при загрузке ассета брони: ID — бинарный поиск, тэги — AND битов
+	FCompiledItemFilter FilterScratch;
+	FItemTagBits TagsScratch;
+	return Armor->GetHelmetFilter(FilterScratch).Allows(Helmet->GetItemDetails().ItemID, Helmet->GetItemTagBits(TagsScratch));
 }
 
 bool UEquipmentComponent::IsBackpackCompatibleWithArmor(const UItemObject* Backpack, const UItemObject* Armor) const
 {
 	if (!IsValid(Backpack) || !IsValid(Armor)) return true;
 
-	const FItemOutfitStatsConfig& ACfg = Armor->OutfitStatsConfig;
-
-	if (!ACfg.bAllowExternalBackpack)
+	if (!Armor->GetOutfitStatsConfig().bAllowExternalBackpack)
 	{
 		return false;
 	}
 
-	return IsAllowedByLists(
-		Backpack,
-		ACfg.AllowedBackpackItemIDs,
-		ACfg.BlockedBackpackItemIDs,
-		ACfg.AllowedBackpackTags,
-		ACfg.BlockedBackpackTags);
+	FCompiledItemFilter FilterScratch;
+	FItemTagBits TagsScratch;
+	return Armor->GetBackpackFilter(FilterScratch).Allows(Backpack->GetItemDetails().ItemID, Backpack->GetItemTagBits(TagsScratch));
 }
 
 void UEquipmentComponent::ApplyArmorModuleSlotsFromEquippedArmor()
@@ -602,7 +1238,7 @@ void UEquipmentComponent::ApplyArmorModuleSlotsFromEquippedArmor()
 		return;
 	}
 
-	const FItemOutfitStatsConfig& ACfg = Armor->OutfitStatsConfig;
+	const FItemOutfitStatsConfig& ACfg = Armor->GetOutfitStatsConfig();
 
 	// clamp на всякий
 	const int32 MaxSlots = FMath::Clamp(ACfg.MaxModuleSlots, 0, 5);
@@ -611,3 +1247,76 @@ void UEquipmentComponent::ApplyArmorModuleSlotsFromEquippedArmor()
 
 	SetArmorModuleSlots(Unlocked, MaxSlots, AfterUpg);
 }
+
+// ===== FEquipmentStatVector =====
+
+FEquipmentStatVector FEquipmentStatVector::FromOutfit(const FItemOutfitStatsConfig& Config)
+{
+	FEquipmentStatVector Out;
+	const FItemProtectionStats& P = Config.Protection;
+
+	Out.Lanes[static_cast<int32>(EEquipmentStatChannel::Radiation)]  = P.Radiation;
+	Out.Lanes[static_cast<int32>(EEquipmentStatChannel::Psi)]        = P.Psi;
+	Out.Lanes[static_cast<int32>(EEquipmentStatChannel::Chemical)]   = P.Chemical;
+	Out.Lanes[static_cast<int32>(EEquipmentStatChannel::Blow)]       = P.Blow;
+	Out.Lanes[static_cast<int32>(EEquipmentStatChannel::Electrical)] = P.Electrical;
+	Out.Lanes[static_cast<int32>(EEquipmentStatChannel::Bullets)]    = P.Bullets;
+	Out.Lanes[static_cast<int32>(EEquipmentStatChannel::Fire)]       = P.Fire;
+	Out.Lanes[static_cast<int32>(EEquipmentStatChannel::CarryBonus)] = Config.CarryBonusWeight;
+
+	return Out;
+}
+
+FItemProtectionStats FEquipmentStatVector::ToProtection() const
+{
+	FItemProtectionStats Out;
+	Out.Radiation  = Get(EEquipmentStatChannel::Radiation);
+	Out.Psi        = Get(EEquipmentStatChannel::Psi);
+	Out.Chemical   = Get(EEquipmentStatChannel::Chemical);
+	Out.Blow       = Get(EEquipmentStatChannel::Blow);
+	Out.Electrical = Get(EEquipmentStatChannel::Electrical);
+	Out.Bullets    = Get(EEquipmentStatChannel::Bullets);
+	Out.Fire       = Get(EEquipmentStatChannel::Fire);
+	return Out;
+}
+
+void FEquipmentStatVector::SumMasked(const FEquipmentStatVector* Terms, int32 NumTerms, uint32 Mask, FEquipmentStatVector& Out)
+{
+	static_assert(static_cast<int32>(EEquipmentStatChannel::Count) == 8, "FEquipmentStatVector is two 4-float registers");
+
+	VectorRegister4Float Lo = VectorZeroFloat();
+	VectorRegister4Float Hi = VectorZeroFloat();
+
+	// Каждый слот — ровно сумма его вклада (без накопления ошибки вычитаний при снятии)
+	while (Mask != 0)
+	{
+		const int32 Index = static_cast<int32>(FMath::CountTrailingZeros(Mask));
+		Mask &= Mask - 1u;
+
+		if (Index < NumTerms)
+		{
+			Lo = VectorAdd(Lo, VectorLoadAligned(&Terms[Index].Lanes[0]));
+			Hi = VectorAdd(Hi, VectorLoadAligned(&Terms[Index].Lanes[4]));
+		}
+	}
+
+	VectorStoreAligned(Lo, &Out.Lanes[0]);
+	VectorStoreAligned(Hi, &Out.Lanes[4]);
+}
+
+FEquipmentChangeScope::FEquipmentChangeScope(UEquipmentComponent* InEquipment)
+	: Equipment(InEquipment)
+{
+	if (IsValid(Equipment))
+	{
+		Equipment->BeginChangeBatch();
+	}
+}
+
+FEquipmentChangeScope::~FEquipmentChangeScope()
+{
+	if (IsValid(Equipment))
+	{
+		Equipment->EndChangeBatch();
+	}
+}
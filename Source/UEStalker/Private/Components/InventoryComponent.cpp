@@ -1,99 +1,87 @@
 #include "Components/InventoryComponent.h"
-#include "Components/EquipmentComponent.h"
+#include "Components/InventoryNotifySubsystem.h"
+#include "Components/InventorySortSolver.h"
+#include "Async/Async.h"
 #include "Items/ItemObject.h"
+#include "Items/ItemObjectPoolSubsystem.h"
+#include "Items/MasterItemDataAsset.h"
 #include "Items/MasterItemActor.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundBase.h"
 
+DEFINE_LOG_CATEGORY_STATIC(LogInventory, Log, All);
+
 UInventoryComponent::UInventoryComponent()
 {
-	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.bStartWithTickEnabled = true;
+	// События рассылает UInventoryNotifySubsystem в конце кадра — тик не нужен
+	PrimaryComponentTick.bCanEverTick = false;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 	
 	Columns = 8;
 	Rows = 11;
 
-	Items.SetNumZeroed(GetCapacity());
-	InvalidateWeight();
+	Cells.SetNumZeroed(GetCapacity());
+	Occupancy.Init(Columns, Rows);
 }
 
 void UInventoryComponent::MarkInventoryChanged()
 {
+	++ContentVersion;
+
+	// Внутри транзакции — одно уведомление на Commit
+	if (TransactionDepth > 0)
+	{
+		bTransactionChanged = true;
+		return;
+	}
+
 	bIsInventoryChanged = true;
-	InvalidateWeight();
+	QueueNotify();
 }
 
 void UInventoryComponent::MarkItemUsed(UItemObject* Item)
 {
 	ItemUsed = Item;
 	bIsItemUsed = true;
+	QueueNotify();
 
 	// Обычно UseItem меняет стак/удаляет предмет -> пусть UI обновится
 	MarkInventoryChanged();
 }
 
-void UInventoryComponent::InvalidateWeight()
-{
-	bWeightDirty = true;
-}
 
-float UInventoryComponent::GetTotalWeight() const
+void UInventoryComponent::MarkItemStateChanged(UItemObject* Item)
 {
-	if (!bWeightDirty)
+	if (!IsValid(Item) || !IsCarried(Item))
 	{
-		return CachedTotalWeight;
+		return;
 	}
 
-	float Total = 0.f;
+	NoteItemDelta(Item, true);
+	UpdateItemIndex(Item);
+	UpdateItemHash(Item);
+	MarkInventoryChanged();
+}
 
-	TSet<const UItemObject*> Seen;
-	Seen.Reserve(Items.Num());
+void UInventoryComponent::InvalidateWeight()
+{
+	WeightLedger.Reset();
+	TotalWeightGrams = StoredWeightGrams;
 
-	for (const TObjectPtr<UItemObject>& Slot : Items)
+	for (const TPair<TObjectPtr<UItemObject>, FInventoryItemPlacement>& Pair : Placements)
 	{
-		const UItemObject* Obj = Slot.Get();
-		if (!IsValid(Obj))
-		{
-			continue;
-		}
-
-		if (Seen.Contains(Obj))
-		{
-			continue;
-		}
-
-		Seen.Add(Obj);
-		Total += GetStackWeight(Obj);
+		PostItemWeight(Pair.Key.Get());
 	}
 
-	// + Equipment weight (equipped items are still carried)
-	if (const AActor* OwnerActor = GetOwner())
+	for (const UItemObject* Eq : EquippedItems)
 	{
-		if (const UEquipmentComponent* EquipComp = OwnerActor->FindComponentByClass<UEquipmentComponent>())
-		{
-			const int32 SlotCount = static_cast<int32>(EEquipmentSlotId::Slot_Count);
-			for (int32 i = 1; i < SlotCount; ++i) // skip None
-			{
-				const UItemObject* Eq = EquipComp->GetItemInSlot(static_cast<EEquipmentSlotId>(i));
-				if (!IsValid(Eq))
-				{
-					continue;
-				}
-	
-				if (Seen.Contains(Eq))
-				{
-					continue;
-				}
-	
-				Seen.Add(Eq);
-				Total += GetStackWeight(Eq);
-			}
-		}
+		PostItemWeight(Eq);
 	}
+}
 
-	CachedTotalWeight = Total;
-	bWeightDirty = false;
-	return CachedTotalWeight;
+float UInventoryComponent::GetTotalWeight() const
+{
+	return static_cast<float>(static_cast<double>(TotalWeightGrams) / 1000.0);
 }
 
 bool UInventoryComponent::CanTakeItem(const UItemObject* ItemObject) const
@@ -103,44 +91,109 @@ bool UInventoryComponent::CanTakeItem(const UItemObject* ItemObject) const
 		return false;
 	}
 
-	return CanTakeAdditionalWeight(GetStackWeight(ItemObject));
+	// Уже несем (перемещение внутри грида / из экипировки в грид) — вес не меняется
+	if (IsCarried(ItemObject))
+	{
+		return true;
+	}
+
+	return CanTakeAdditionalWeightGrams(GetStackWeightGrams(ItemObject));
 }
 
 bool UInventoryComponent::CanTakeAdditionalWeight(float AddWeight) const
 {
-	if (MaxCarryWeight <= 0.f)
+	return CanTakeAdditionalWeightGrams(WeightToGrams(AddWeight));
+}
+
+bool UInventoryComponent::CanTakeAdditionalWeightGrams(int64 AddGrams) const
+{
+	const float MaxWeight = GetMaxCarryWeight();
+	if (MaxWeight <= 0.f)
 	{
 		return true; // без лимита
 	}
 
-	AddWeight = FMath::Max(0.f, AddWeight);
-	return (GetTotalWeight() + AddWeight) <= (MaxCarryWeight + KINDA_SMALL_NUMBER);
+	return TotalWeightGrams + FMath::Max<int64>(0, AddGrams) <= WeightToGrams(MaxWeight);
+}
+
+void UInventoryComponent::SetCarryBonusWeight(float NewBonus)
+{
+	NewBonus = FMath::Max(0.f, NewBonus);
+	if (NewBonus == CarryBonusWeight)
+	{
+		return;
+	}
+
+	CarryBonusWeight = NewBonus;
+
+	// Лимит в UI (вес/макс) — обычным уведомлением
+	MarkInventoryChanged();
 }
 
 void UInventoryComponent::SetGridSize(int32 NewColumns, int32 NewRows)
 {
+	// Хранимые по значению предметы тоже могут не влезть — переразмещаем их как обычные
+	MaterializeItems();
+
 	Columns = FMath::Max(1, NewColumns);
 	Rows    = FMath::Max(1, NewRows);
 
-	Items.SetNumZeroed(GetCapacity());
+	// Предметы, которые больше не влезают на свое место, переразмещаем first-fit
+	TArray<UItemObject*> Displaced;
+	for (auto It = Placements.CreateIterator(); It; ++It)
+	{
+		const FIntRect Rect = It.Value().GetRect();
+		if (Rect.Max.X > Columns || Rect.Max.Y > Rows)
+		{
+			RecordItemState(It.Key());
+			NoteItemDelta(It.Key(), false);
+			Displaced.Add(It.Key());
+			It.RemoveCurrent();
+			SyncItemIndices(Displaced.Last());
+		}
+	}
+
+	RebuildGridFromPlacements();
+	bPendingFullRefresh = true;
+
+	for (UItemObject* Item : Displaced)
+	{
+		int32 TopLeftIndex = INDEX_NONE;
+		bool bRotate = false;
+		const bool bFound = FindFreeSpot(Item, TopLeftIndex, bRotate);
+		if (bFound)
+		{
+			Item->Runtime.bIsRotated ^= bRotate;
+		}
+		if (!bFound || !AddItemAt(Item, TopLeftIndex))
+		{
+			UE_LOG(LogInventory, Warning, TEXT("SetGridSize: %s does not fit into %dx%d grid and was removed"),
+				*GetNameSafe(Item), Columns, Rows);
+		}
+	}
+
 	MarkInventoryChanged();
 }
 
 void UInventoryComponent::GetItemAtIndex(int32 Index, bool& bValid, UItemObject*& ItemObject) const
 {
-	bValid = Items.IsValidIndex(Index);
-	ItemObject = bValid ? Items[Index].Get() : nullptr;
+	bValid = Cells.IsValidIndex(Index);
+	ItemObject = bValid ? ItemTable.Resolve(Cells[Index]) : nullptr;
+
+	// Занятая клетка с мертвым хэндлом — рассинхрон Cells и Placements
+	ensureMsgf(!bValid || Cells[Index] == FInventoryItemTable::InvalidHandle || ItemObject != nullptr,
+		TEXT("GetItemAtIndex: stale item handle %u at cell %d"), Cells[Index], Index);
 }
 
 TArray<UItemObject*> UInventoryComponent::GetAllItems() const
 {
 	TArray<UItemObject*> AllItems;
-	AllItems.Reserve(Items.Num());
+	AllItems.Reserve(Placements.Num());
 
-	for (const TObjectPtr<UItemObject>& It : Items)
+	for (const TPair<TObjectPtr<UItemObject>, FInventoryItemPlacement>& Pair : Placements)
 	{
-		UItemObject* Obj = It.Get();
-		if (IsValid(Obj) && !AllItems.Contains(Obj))
+		UItemObject* Obj = Pair.Key.Get();
+		if (IsValid(Obj))
 		{
 			AllItems.Add(Obj);
 		}
@@ -149,6 +202,38 @@ TArray<UItemObject*> UInventoryComponent::GetAllItems() const
 	return AllItems;
 }
 
+
+TArray<UItemObject*> UInventoryComponent::GetItemsByCategory(EItemCategory Category) const
+{
+	const TArray<UItemObject*>* Items = ItemIndex.FindCategory(Category);
+	return Items ? *Items : TArray<UItemObject*>();
+}
+
+TArray<UItemObject*> UInventoryComponent::GetItemsByFilter(EItemFilter Filter) const
+{
+	if (Filter == EItemFilter::Filter_All)
+	{
+		return GetAllItems();
+	}
+
+	const TArray<UItemObject*>* Items = ItemIndex.FindFilter(Filter);
+	return Items ? *Items : TArray<UItemObject*>();
+}
+
+TArray<UItemObject*> UInventoryComponent::GetSortedItems(EInventorySortKey SortKey, bool bDescending, EItemCategory Category) const
+{
+	TArray<UItemObject*> Result;
+
+	if (Category == EItemCategory::ItemCat_None)
+	{
+		ItemIndex.GetSorted(SortKey, bDescending, Result);
+		return Result;
+	}
+
+	ItemIndex.GetSortedInCategory(SortKey, bDescending, Category, Result);
+	return Result;
+}
+
 int32 UInventoryComponent::FindTopLeftIndexForItem(const UItemObject* ItemObject) const
 {
 	if (!IsValid(ItemObject))
@@ -156,15 +241,26 @@ int32 UInventoryComponent::FindTopLeftIndexForItem(const UItemObject* ItemObject
 		return INDEX_NONE;
 	}
 
-	for (int32 i = 0; i < Items.Num(); ++i)
+	const FInventoryItemPlacement* Placement = FindPlacement(ItemObject);
+	return Placement ? TileToIndex(Placement->TopLeftTile) : INDEX_NONE;
+}
+
+bool UInventoryComponent::GetItemPlacement(const UItemObject* ItemObject, FInventoryItemPlacement& OutPlacement) const
+{
+	const FInventoryItemPlacement* Placement = IsValid(ItemObject) ? FindPlacement(ItemObject) : nullptr;
+	if (!Placement)
 	{
-		if (Items[i].Get() == ItemObject)
-		{
-			return i;
-		}
+		OutPlacement = FInventoryItemPlacement();
+		return false;
 	}
 
-	return INDEX_NONE;
+	OutPlacement = *Placement;
+	return true;
+}
+
+bool UInventoryComponent::ContainsItem(const UItemObject* ItemObject) const
+{
+	return IsValid(ItemObject) && FindPlacement(ItemObject) != nullptr;
 }
 
 bool UInventoryComponent::IsRoomAvailableForMove(UItemObject* ItemObject, int32 TopLeftIndex) const
@@ -175,7 +271,7 @@ bool UInventoryComponent::IsRoomAvailableForMove(UItemObject* ItemObject, int32
 	}
 
 	const int32 Cap = GetCapacity();
-	if (Cap <= 0 || Items.Num() != Cap)
+	if (Cap <= 0 || Cells.Num() != Cap)
 	{
 		return false;
 	}
@@ -188,34 +284,36 @@ bool UInventoryComponent::IsRoomAvailableForMove(UItemObject* ItemObject, int32
 
 	const FIntPoint Size = GetEffectiveItemSize(ItemObject);
 
-	for (int32 Y = 0; Y < Size.Y; ++Y)
+	// Клетки, которые уже занимает этот же предмет, считаем свободными
+	if (const FInventoryItemPlacement* Current = Placements.Find(ItemObject))
 	{
-		for (int32 X = 0; X < Size.X; ++X)
-		{
-			FTile Tile;
-			Tile.X = TopLeftTile.X + X;
-			Tile.Y = TopLeftTile.Y + Y;
+		return Occupancy.IsRectFreeIgnoring(TopLeftTile.X, TopLeftTile.Y, Size.X, Size.Y, Current->GetRect());
+	}
 
-			if (!IsTileInBounds(Tile))
-			{
-				return false;
-			}
+	return Occupancy.IsRectFree(TopLeftTile.X, TopLeftTile.Y, Size.X, Size.Y);
+}
 
-			const int32 SlotIndex = TileToIndex(Tile);
-			if (!Items.IsValidIndex(SlotIndex))
-			{
-				return false;
-			}
 
-			UItemObject* Occupant = Items[SlotIndex].Get();
-			if (IsValid(Occupant) && Occupant != ItemObject)
-			{
-				return false;
-			}
-		}
+void UInventoryComponent::BuildPlacementMask(const UItemObject* ItemObject, bool bIgnoreOwnCells, FInventoryPlacementMask& OutMask) const
+{
+	if (!IsValid(ItemObject) || GetCapacity() <= 0)
+	{
+		OutMask.Reset();
+		return;
 	}
 
-	return true;
+	const FIntPoint Size = GetEffectiveItemSize(ItemObject);
+
+	const FInventoryItemPlacement* Current = bIgnoreOwnCells ? FindPlacement(ItemObject) : nullptr;
+	if (Current)
+	{
+		const FIntRect OwnCells = Current->GetRect();
+		OutMask.Build(Occupancy, Size.X, Size.Y, &OwnCells);
+	}
+	else
+	{
+		OutMask.Build(Occupancy, Size.X, Size.Y);
+	}
 }
 
 FTile UInventoryComponent::IndexToTile(int32 Index) const
@@ -250,45 +348,67 @@ int32 UInventoryComponent::TileToIndex(const FTile& Tile) const
 	return Tile.X + (Tile.Y * Columns);
 }
 
-void UInventoryComponent::AddItemAt(UItemObject* ItemObject, int32 TopLeftIndex)
+bool UInventoryComponent::AddItemAt(UItemObject* ItemObject, int32 TopLeftIndex)
 {
 	if (!IsValid(ItemObject))
 	{
-		return;
+		return false;
 	}
 
 	// Страховка размера массива
-	const int32 Cap = GetCapacity();
-	if (Items.Num() != Cap)
-	{
-		Items.SetNumZeroed(Cap);
-	}
+	EnsureGridStorage();
 
 	const FTile TopLeftTile = IndexToTile(TopLeftIndex);
 	if (!IsTileInBounds(TopLeftTile))
 	{
-		return;
+		return false;
 	}
 
-	const FIntPoint Size = GetEffectiveItemSize(ItemObject);
+	// Не даем перекрыть чужие клетки: таблица размещений должна оставаться непротиворечивой
+	if (!IsRoomAvailableForMove(ItemObject, TopLeftIndex))
+	{
+		UE_LOG(LogInventory, Warning, TEXT("AddItemAt: no room for %s at index %d"), *GetNameSafe(ItemObject), TopLeftIndex);
+		return false;
+	}
 
-	for (int32 Y = 0; Y < Size.Y; ++Y)
+	// Новому предмету нужен слот в таблице хэндлов клеток
+	if (!Placements.Contains(ItemObject) && ItemTable.IsFull())
 	{
-		for (int32 X = 0; X < Size.X; ++X)
-		{
-			FTile Tile;
-			Tile.X = TopLeftTile.X + X;
-			Tile.Y = TopLeftTile.Y + Y;
+		UE_LOG(LogInventory, Warning, TEXT("AddItemAt: item table is full (%d items), %s rejected"),
+			FInventoryItemTable::MaxItems, *GetNameSafe(ItemObject));
+		return false;
+	}
 
-			const int32 SlotIndex = TileToIndex(Tile);
-			if (SlotIndex != INDEX_NONE && Items.IsValidIndex(SlotIndex))
-			{
-				Items[SlotIndex] = ItemObject;
-			}
-		}
+	RecordItemState(ItemObject);
+	NoteItemDelta(ItemObject, false);
+
+	// Уже лежит в гриде -> это перемещение: стираем только его старый прямоугольник
+	const FInventoryItemPlacement* OldPlacement = Placements.Find(ItemObject);
+	const bool bIsMove = OldPlacement != nullptr;
+	if (bIsMove)
+	{
+		WriteFootprint(*OldPlacement, nullptr);
+	}
+
+	FInventoryItemPlacement Placement;
+	Placement.TopLeftTile = TopLeftTile;
+	Placement.Size = GetEffectiveItemSize(ItemObject);
+	Placement.bRotated = ItemObject->Runtime.bIsRotated;
+
+	Placements.Add(ItemObject, Placement);
+	WriteFootprint(Placement, ItemObject);
+
+	if (!bIsMove)
+	{
+		SyncItemIndices(ItemObject);
+	}
+	else
+	{
+		UpdateItemHash(ItemObject);
 	}
 
 	MarkInventoryChanged();
+	return true;
 }
 
 bool UInventoryComponent::IsRoomAvailable(UItemObject* ItemObject, int32 TopLeftIndex) const
@@ -299,7 +419,7 @@ bool UInventoryComponent::IsRoomAvailable(UItemObject* ItemObject, int32 TopLeft
 	}
 
 	const int32 Cap = GetCapacity();
-	if (Cap <= 0 || Items.Num() != Cap)
+	if (Cap <= 0 || Cells.Num() != Cap)
 	{
 		return false;
 	}
@@ -310,36 +430,9 @@ bool UInventoryComponent::IsRoomAvailable(UItemObject* ItemObject, int32 TopLeft
 		return false;
 	}
 
+	// Ячейка занята любым предметом -> места нет
 	const FIntPoint Size = GetEffectiveItemSize(ItemObject);
-
-	for (int32 Y = 0; Y < Size.Y; ++Y)
-	{
-		for (int32 X = 0; X < Size.X; ++X)
-		{
-			FTile Tile;
-			Tile.X = TopLeftTile.X + X;
-			Tile.Y = TopLeftTile.Y + Y;
-
-			if (!IsTileInBounds(Tile))
-			{
-				return false;
-			}
-
-			const int32 SlotIndex = TileToIndex(Tile);
-			if (!Items.IsValidIndex(SlotIndex))
-			{
-				return false;
-			}
-
-			// Ячейка занята любым предметом -> места нет
-			if (IsValid(Items[SlotIndex].Get()))
-			{
-				return false;
-			}
-		}
-	}
-
-	return true;
+	return Occupancy.IsRectFree(TopLeftTile.X, TopLeftTile.Y, Size.X, Size.Y);
 }
 
 bool UInventoryComponent::TryAddItem(UItemObject* ItemObject)
@@ -361,64 +454,17 @@ bool UInventoryComponent::TryAddItem(UItemObject* ItemObject)
 		return false;
 	}
 
-	if (Items.Num() != Cap)
-	{
-		Items.SetNumZeroed(Cap);
-		InvalidateWeight();
-	}
+	EnsureGridStorage();
+	RecordItemState(ItemObject);
 
-	// если стакуемое — сначала докидываем в существующие стаки
+	// если стакуемое — сначала докидываем в существующие неполные стаки (индекс по SourceAsset)
 	if (ItemObject->IsStackable())
 	{
 		int32 Remaining = FMath::Max(1, ItemObject->Runtime.StackCount);
-		const int32 MaxStack = FMath::Max(1, ItemObject->GetMaxStack());
-
-		bool bMergedAnything = false;
-
-		if (MaxStack > 1)
-		{
-			TSet<UItemObject*> Seen;
-			Seen.Reserve(Items.Num());
-
-			for (const TObjectPtr<UItemObject>& Slot : Items)
-			{
-				UItemObject* Existing = Slot.Get();
-				if (!IsValid(Existing) || Seen.Contains(Existing))
-				{
-					continue;
-				}
-				Seen.Add(Existing);
-
-				if (!AreStackCompatible(Existing, ItemObject))
-				{
-					continue;
-				}
-
-				const int32 Curr = FMath::Max(1, Existing->Runtime.StackCount);
-				const int32 Space = FMath::Max(0, MaxStack - Curr);
-				if (Space <= 0)
-				{
-					continue;
-				}
-
-				const int32 Add = FMath::Min(Space, Remaining);
-				if (Add > 0)
-				{
-					Existing->SetStackCount(Curr + Add);
-					Remaining -= Add;
-					bMergedAnything = true;
-
-					if (Remaining <= 0)
-					{
-						break;
-					}
-				}
-			}
-		}
 
-		if (bMergedAnything)
+		if (ItemObject->GetMaxStack() > 1)
 		{
-			MarkInventoryChanged(); // обновим UI + вес
+			Remaining -= AddToExistingStacks(ItemObject->SourceAsset, Remaining, ItemObject); // внутри пометим InventoryChanged
 		}
 
 		// Полностью докинули в стаки — новый слот не нужен
@@ -431,17 +477,25 @@ bool UInventoryComponent::TryAddItem(UItemObject* ItemObject)
 		ItemObject->SetStackCount(Remaining);
 	}
 
-	// Пытаемся положить предмет в первый подходящий слот
-	for (int32 TopLeftIndex = 0; TopLeftIndex < Items.Num(); ++TopLeftIndex)
+	// Новому предмету в гриде нужен хэндл клеток; остаток стака остается в объекте (как и без места)
+	if (ItemTable.IsFull() && !Placements.Contains(ItemObject))
 	{
-		if (IsRoomAvailable(ItemObject, TopLeftIndex))
-		{
-			AddItemAt(ItemObject, TopLeftIndex); // внутри пометим InventoryChanged
-			return true;
-		}
+		return false;
 	}
 
-	return false;
+	// Ищем место по стратегии инвентаря (битовая карта, обе ориентации)
+	int32 TopLeftIndex = INDEX_NONE;
+	bool bRotate = false;
+	if (!FindFreeSpot(ItemObject, TopLeftIndex, bRotate))
+	{
+		return false;
+	}
+
+	// Влезло только повернутым — поворачиваем сам предмет
+	ItemObject->Runtime.bIsRotated ^= bRotate;
+
+	// Таблица хэндлов могла кончиться — тогда предмет не лег, и это не успех
+	return AddItemAt(ItemObject, TopLeftIndex); // внутри пометим InventoryChanged
 }
 
 void UInventoryComponent::RemoveItem(UItemObject* ItemObject)
@@ -451,21 +505,19 @@ void UInventoryComponent::RemoveItem(UItemObject* ItemObject)
 		return;
 	}
 
-	bool bChanged = false;
+	RecordItemState(ItemObject);
+	NoteItemDelta(ItemObject, false);
 
-	for (int32 i = 0; i < Items.Num(); ++i)
+	// Трогаем только клетки самого предмета
+	FInventoryItemPlacement Placement;
+	if (!Placements.RemoveAndCopyValue(ItemObject, Placement))
 	{
-		if (Items[i].Get() == ItemObject)
-		{
-			Items[i] = nullptr;
-			bChanged = true;
-		}
+		return;
 	}
 
-	if (bChanged)
-	{
-		MarkInventoryChanged();
-	}
+	WriteFootprint(Placement, nullptr);
+	SyncItemIndices(ItemObject);
+	MarkInventoryChanged();
 }
 
 void UInventoryComponent::DropItem(AActor* Actor, UItemObject* ItemObject, bool bGroundClamp)
@@ -501,7 +553,7 @@ void UInventoryComponent::DropItem(AActor* Actor, UItemObject* ItemObject, bool
 		}
 	}
 
-	TSubclassOf<AActor> ClassToSpawn = ItemObject->ItemDetails.ItemClass;
+	TSubclassOf<AActor> ClassToSpawn = ItemObject->GetItemDetails().ItemClass;
 	if (!ClassToSpawn)
 	{
 		return;
@@ -511,7 +563,7 @@ void UInventoryComponent::DropItem(AActor* Actor, UItemObject* ItemObject, bool
 	// Если ItemClass указывает на "оружие в руках" (или любой актор не-pickup),
 	// делаем fallback на AMasterItemActor.
 	// Исключение: Placeable — там можно спавнить реальный актор из ItemClass.
-	const bool bAllowCustomWorldActor = (ItemObject->ItemDetails.ItemCategory == EItemCategory::ItemCat_Placeable);
+	const bool bAllowCustomWorldActor = (ItemObject->GetItemDetails().ItemCategory == EItemCategory::ItemCat_Placeable);
 
 	if (!bAllowCustomWorldActor && !ClassToSpawn->IsChildOf(AMasterItemActor::StaticClass()))
 	{
@@ -549,9 +601,9 @@ void UInventoryComponent::DropItem(AActor* Actor, UItemObject* ItemObject, bool
 	}
 
 	// Звук дропа (если задан)
-	if (ItemObject->ItemDetails.ItemDropSound)
+	if (ItemObject->GetItemDetails().ItemDropSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(World, ItemObject->ItemDetails.ItemDropSound, SpawnLocation);
+		UGameplayStatics::PlaySoundAtLocation(World, ItemObject->GetItemDetails().ItemDropSound, SpawnLocation);
 	}
 
 	// Удаляем из инвентаря
@@ -565,10 +617,13 @@ void UInventoryComponent::UseItem(UItemObject* ItemObject)
 		return;
 	}
 
+	RecordItemState(ItemObject);
+
 	// Уменьшаем стак или удаляем
 	const int32 CurrentCount = FMath::Max(1, ItemObject->Runtime.StackCount);
+	const bool bConsumed = CurrentCount <= 1;
 
-	if (CurrentCount > 1)
+	if (!bConsumed)
 	{
 		ItemObject->SetStackCount(CurrentCount - 1);
 	}
@@ -586,6 +641,12 @@ void UInventoryComponent::UseItem(UItemObject* ItemObject)
 		const FVector Loc = GetOwner() ? GetOwner()->GetActorLocation() : FVector::ZeroVector;
 		UGameplayStatics::PlaySoundAtLocation(this, UseSound, Loc);
 	}
+
+	// Израсходован — в пул после FlushNotifications: OnItemUsed и дельта еще ссылаются на него
+	if (bConsumed)
+	{
+		PendingReleases.Add(ItemObject);
+	}
 }
 
 bool UInventoryComponent::CanApplyItemToItem(const UItemObject* Payload, const UItemObject* Target) const
@@ -598,7 +659,7 @@ bool UInventoryComponent::CanApplyItemToItem(const UItemObject* Payload, const U
 	// Ammo -> Magazine
 	if (Payload->IsAmmo() && Target->IsMagazine())
 	{
-		const EAmmoType AmmoType = Payload->ItemDetails.AmmoType;
+		const EAmmoType AmmoType = Payload->GetItemDetails().AmmoType;
 		if (AmmoType == EAmmoType::AmmoType_None)
 		{
 			return false;
@@ -645,6 +706,65 @@ bool UInventoryComponent::CanApplyItemToItem(const UItemObject* Payload, const U
 	return false;
 }
 
+
+
+void UInventoryComponent::GetAppliableTargets(const UItemObject* Payload, TArray<UItemObject*>& OutTargets) const
+{
+	OutTargets.Reset();
+
+	if (!IsValid(Payload))
+	{
+		return;
+	}
+
+	// Применять можно только патроны (в магазин/оружие) и магазины (в оружие)
+	const bool bAmmo = Payload->IsAmmo();
+	const bool bMagazine = Payload->IsMagazine();
+	if (!bAmmo && !bMagazine)
+	{
+		return;
+	}
+
+	// Отсев по маскам до полной проверки: патроны — магазины с нужным битом, магазин — любое оружие
+	const uint64 AmmoBit = bAmmo ? UMasterItemDataAsset::AmmoTypeBit(Payload->GetItemDetails().AmmoType) : 0;
+
+	auto Consider = [&](UItemObject* Target)
+	{
+		if (!IsValid(Target) || Target == Payload)
+		{
+			return;
+		}
+
+		if (bAmmo)
+		{
+			const UItemObject* Magazine = Target->IsWeapon() ? Target->GetInsertedMagazine() : Target;
+			if (!IsValid(Magazine) || !Magazine->IsMagazine() || (Magazine->GetCompatibleAmmoMask() & AmmoBit) == 0)
+			{
+				return;
+			}
+		}
+		else if (!Target->IsWeapon())
+		{
+			return;
+		}
+
+		if (CanApplyItemToItem(Payload, Target))
+		{
+			OutTargets.Add(Target);
+		}
+	};
+
+	for (const TPair<TObjectPtr<UItemObject>, FInventoryItemPlacement>& Pair : Placements)
+	{
+		Consider(Pair.Key.Get());
+	}
+
+	for (UItemObject* Equipped : EquippedItems)
+	{
+		Consider(Equipped);
+	}
+}
+
 bool UInventoryComponent::TryApplyItemToItem(UItemObject* Payload, UItemObject* Target, int32 RequestedCount, int32& OutAppliedCount)
 {
 	OutAppliedCount = 0;
@@ -699,9 +819,13 @@ bool UInventoryComponent::TryApplyItemToItem(UItemObject* Payload, UItemObject*
 			return false;
 		}
 
+		FInventoryTransactionScope Transaction(this);
+		RecordItemState(Target);
+		RecordItemState(Payload);
+
 		// set magazine ammo type & unit weight on first load
-		Target->SetMagazineLoadedAmmoType(Payload->ItemDetails.AmmoType);
-		Target->SetMagazineAmmoUnitWeight(FMath::Max(0.f, Payload->ItemDetails.ItemWeight));
+		Target->SetMagazineLoadedAmmoType(Payload->GetItemDetails().AmmoType);
+		Target->SetMagazineAmmoUnitWeight(FMath::Max(0.f, Payload->GetItemDetails().ItemWeight));
 		Target->SetMagazineCurrentAmmo(Curr + ToLoad);
 
 		// consume ammo stack
@@ -713,11 +837,17 @@ bool UInventoryComponent::TryApplyItemToItem(UItemObject* Payload, UItemObject*
 		else
 		{
 			Payload->SetStackCount(NewCount);
-			MarkInventoryChanged();
 		}
 
 		OutAppliedCount = ToLoad;
 		MarkInventoryChanged();
+		Transaction.Commit();
+
+		// Пачка патронов израсходована целиком — в пул
+		if (NewCount <= 0 && TransactionDepth == 0)
+		{
+			UItemObjectPoolSubsystem::ReleaseItem(this, Payload);
+		}
 		return true;
 	}
 
@@ -729,22 +859,32 @@ bool UInventoryComponent::TryApplyItemToItem(UItemObject* Payload, UItemObject*
 			return false;
 		}
 
+		// Свап — несколько шагов: при неудаче откат вернет старый магазин в оружие
+		FInventoryTransactionScope Transaction(this);
+		RecordItemState(Target);
+		RecordItemState(Payload);
+
 		// If weapon already has a magazine — try swap back to inventory
 		UItemObject* ExistingMag = Target->GetInsertedMagazine();
 		if (IsValid(ExistingMag))
 		{
+			RecordItemState(ExistingMag);
+
+			// Сначала извлекаем: вес магазина уходит из оружия и не считается дважды
+			Target->SetInsertedMagazine(nullptr);
+
 			// We need some free space to return old magazine
 			if (!TryAddItem(ExistingMag))
 			{
 				return false;
 			}
-			Target->SetInsertedMagazine(nullptr);
 		}
 
 		// Remove payload from inventory and insert into weapon
 		RemoveItem(Payload);
 		Target->SetInsertedMagazine(Payload);
 		MarkInventoryChanged();
+		Transaction.Commit();
 		return true;
 	}
 
@@ -792,41 +932,106 @@ void UInventoryComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	const int32 Cap = GetCapacity();
-	if (Cap > 0)
-	{
-		Items.SetNumZeroed(Cap);
-		InvalidateWeight();
-	}
+	EnsureGridStorage();
 }
 
 void UInventoryComponent::OnRegister()
 {
 	Super::OnRegister();
 
-	const int32 Cap = GetCapacity();
-	if (Cap > 0 && Items.Num() != Cap)
+	EnsureGridStorage();
+}
+
+void UInventoryComponent::QueueNotify()
+{
+	if (bNotifyQueued)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	UInventoryNotifySubsystem* Notify = World ? World->GetSubsystem<UInventoryNotifySubsystem>() : nullptr;
+	if (!Notify)
 	{
-		Items.SetNumZeroed(Cap);
-		InvalidateWeight();
+		return; // нет мира (CDO/превью) — слушать некому, флаги дождутся следующего изменения
 	}
+
+	bNotifyQueued = true;
+	Notify->QueueInventory(this);
 }
 
-void UInventoryComponent::TickComponent(float DeltaTime, ELevelTick TickType,
-	FActorComponentTickFunction* ThisTickFunction)
+void UInventoryComponent::FlushNotifications()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	// Сбрасываем до рассылки: обработчики могут снова поменять инвентарь
+	bNotifyQueued = false;
+
+	// Сначала точная дельта, потом общий сигнал (вес/счетчики)
+	// Динамические делегаты (ProcessEvent) дергаем только при живых Blueprint-подписчиках
+	if (PendingDeltas.Num() > 0 || bPendingFullRefresh)
+	{
+		if (OnInventoryDeltaNative.IsBound() || OnInventoryDelta.IsBound())
+		{
+			FInventoryDelta Delta;
+			BuildPendingDelta(Delta);
+
+			if (Delta.bFullRefresh || Delta.Items.Num() > 0)
+			{
+				OnInventoryDeltaNative.Broadcast(Delta);
+
+				if (OnInventoryDelta.IsBound())
+				{
+					OnInventoryDelta.Broadcast(Delta);
+				}
+			}
+		}
+		else
+		{
+			// Никто не слушает (NPC) — дельту даже не собираем
+			PendingDeltas.Reset();
+			bPendingFullRefresh = false;
+		}
+	}
 
 	if (bIsInventoryChanged)
 	{
 		bIsInventoryChanged = false;
-		OnInventoryChanged.Broadcast();
+		OnInventoryChangedNative.Broadcast();
+
+		if (OnInventoryChanged.IsBound())
+		{
+			OnInventoryChanged.Broadcast();
+		}
 	}
 
 	if (bIsItemUsed)
 	{
 		bIsItemUsed = false;
-		OnItemUsed.Broadcast(ItemUsed);
+		OnItemUsedNative.Broadcast(ItemUsed);
+
+		if (OnItemUsed.IsBound())
+		{
+			OnItemUsed.Broadcast(ItemUsed);
+		}
+	}
+
+	// Все, кто ждал события, их получили — израсходованное можно отдать в пул.
+	// Откат транзакции мог вернуть предмет в грид — такой остается
+	if (PendingReleases.Num() > 0)
+	{
+		TArray<TObjectPtr<UItemObject>> Releases = MoveTemp(PendingReleases);
+		for (UItemObject* Item : Releases)
+		{
+			if (!IsValid(Item) || IsCarried(Item))
+			{
+				continue;
+			}
+
+			if (ItemUsed == Item)
+			{
+				ItemUsed = nullptr;
+			}
+			UItemObjectPoolSubsystem::ReleaseItem(this, Item);
+		}
 	}
 }
 
@@ -837,8 +1042,8 @@ FIntPoint UInventoryComponent::GetEffectiveItemSize(const UItemObject* ItemObjec
 		return FIntPoint(1, 1);
 	}
 
-	int32 SX = FMath::Max(1, ItemObject->ItemDetails.Size.X);
-	int32 SY = FMath::Max(1, ItemObject->ItemDetails.Size.Y);
+	int32 SX = FMath::Max(1, ItemObject->GetItemDetails().Size.X);
+	int32 SY = FMath::Max(1, ItemObject->GetItemDetails().Size.Y);
 
 	if (ItemObject->Runtime.bIsRotated)
 	{
@@ -848,23 +1053,43 @@ FIntPoint UInventoryComponent::GetEffectiveItemSize(const UItemObject* ItemObjec
 	return FIntPoint(SX, SY);
 }
 
-float UInventoryComponent::GetStackWeight(const UItemObject* ItemObject) const
+
+bool UInventoryComponent::FindFreeSpot(const UItemObject* ItemObject, int32& OutTopLeftIndex, bool& bOutRotated) const
 {
+	OutTopLeftIndex = INDEX_NONE;
+	bOutRotated = false;
+
 	if (!IsValid(ItemObject))
 	{
-		return 0.f;
+		return false;
+	}
+
+	FIntPoint TopLeft;
+	if (!FInventoryPlacementSolver::FindPlacement(Occupancy, PlacementStrategy, GetEffectiveItemSize(ItemObject),
+		ItemObject->GetItemDetails().bCanRotate, TopLeft, bOutRotated))
+	{
+		return false;
 	}
 
-	float Total = 0.f;
+	OutTopLeftIndex = TopLeft.X + (TopLeft.Y * Columns);
+	return true;
+}
+
+int64 UInventoryComponent::GetStackWeightGrams(const UItemObject* ItemObject) const
+{
+	if (!IsValid(ItemObject))
+	{
+		return 0;
+	}
 
-	const float UnitW = FMath::Max(0.f, ItemObject->ItemDetails.ItemWeight);
+	// Округляем вес единицы, а не сумму: одна и та же пачка всегда дает одни и те же граммы
 	const int32 Count = FMath::Max(1, ItemObject->Runtime.StackCount);
-	Total += UnitW * (float)Count;
+	int64 Total = WeightToGrams(ItemObject->GetItemDetails().ItemWeight) * Count;
 
 	// Magazine carries ammo weight
 	if (ItemObject->IsMagazine())
 	{
-		Total += (float)FMath::Max(0, ItemObject->GetMagazineCurrentAmmo()) * FMath::Max(0.f, ItemObject->GetMagazineAmmoUnitWeight());
+		Total += WeightToGrams(ItemObject->GetMagazineAmmoUnitWeight()) * FMath::Max(0, ItemObject->GetMagazineCurrentAmmo());
 	}
 
 	// Weapon carries inserted magazine weight
@@ -872,25 +1097,1155 @@ float UInventoryComponent::GetStackWeight(const UItemObject* ItemObject) const
 	{
 		if (const UItemObject* Inserted = ItemObject->GetInsertedMagazine())
 		{
-			Total += GetStackWeight(Inserted);
+			Total += GetStackWeightGrams(Inserted);
 		}
 	}
 
 	return Total;
 }
 
-bool UInventoryComponent::AreStackCompatible(const UItemObject* A, const UItemObject* B) const
+int32 UInventoryComponent::AddToExistingStacks(UMasterItemDataAsset* Asset, int32 Count, const UItemObject* Exclude)
 {
-	if (!IsValid(A) || !IsValid(B))
+	if (!Asset || Count <= 0)
 	{
-		return false;
+		return 0;
 	}
 
-	if (!A->IsStackable() || !B->IsStackable())
+	const TArray<UItemObject*, TInlineAllocator<2>>* Open = OpenStacks.Find(Asset);
+	if (!Open)
 	{
-		return false;
+		return 0;
+	}
+
+	// Копия: заполненный стак уходит из индекса прямо внутри SetStackCount
+	const TArray<UItemObject*, TInlineAllocator<4>> Candidates(*Open);
+
+	int32 Merged = 0;
+	for (UItemObject* Existing : Candidates)
+	{
+		if (Merged >= Count)
+		{
+			break;
+		}
+
+		if (!IsValid(Existing) || Existing == Exclude)
+		{
+			continue;
+		}
+
+		const int32 Curr = FMath::Max(1, Existing->Runtime.StackCount);
+		const int32 Space = FMath::Max(0, Existing->GetMaxStack() - Curr);
+		const int32 Add = FMath::Min(Space, Count - Merged);
+		if (Add <= 0)
+		{
+			continue;
+		}
+
+		RecordItemState(Existing);
+		Existing->SetStackCount(Curr + Add);
+		Merged += Add;
+	}
+
+	if (Merged > 0)
+	{
+		MarkInventoryChanged(); // обновим UI + вес
+	}
+
+	return Merged;
+}
+
+void UInventoryComponent::NotifyItemStackChanged(UItemObject* ItemObject)
+{
+	if (!IsValid(ItemObject) || !ContainsItem(ItemObject))
+	{
+		return;
+	}
+
+	++ContentVersion;
+	NoteItemDelta(ItemObject, true);
+	UpdateOpenStack(ItemObject);
+	UpdateItemIndex(ItemObject);
+	UpdateItemHash(ItemObject);
+}
+
+void UInventoryComponent::NotifyItemWeightChanged(UItemObject* ItemObject)
+{
+	if (!IsValid(ItemObject) || !WeightLedger.Contains(ItemObject))
+	{
+		return;
+	}
+
+	++ContentVersion;
+	NoteItemDelta(ItemObject, true);
+	PostItemWeight(ItemObject);
+	UpdateItemIndex(ItemObject);
+	UpdateItemHash(ItemObject);
+}
+
+void UInventoryComponent::NotifyItemConfigChanged(UItemObject* ItemObject)
+{
+	if (!IsValid(ItemObject) || !IsCarried(ItemObject))
+	{
+		return;
+	}
+
+	// Конфиг мог сменить MaxStack/категорию/вес — переучитываем предмет целиком
+	NoteItemDelta(ItemObject, true);
+	SyncItemIndices(ItemObject);
+	MarkInventoryChanged();
+}
+
+void UInventoryComponent::SetItemEquipped(UItemObject* ItemObject, bool bEquipped)
+{
+	if (!IsValid(ItemObject))
+	{
+		return;
+	}
+
+	if (bEquipped)
+	{
+		EquippedItems.Add(ItemObject);
+	}
+	else
+	{
+		EquippedItems.Remove(ItemObject);
+	}
+
+	SyncItemIndices(ItemObject);
+}
+
+void UInventoryComponent::PostItemWeight(const UItemObject* ItemObject)
+{
+	int64 OldGrams = 0;
+	WeightLedger.RemoveAndCopyValue(ItemObject, OldGrams);
+
+	int64 NewGrams = 0;
+	if (IsValid(ItemObject) && IsCarried(ItemObject))
+	{
+		NewGrams = GetStackWeightGrams(ItemObject);
+		WeightLedger.Add(ItemObject, NewGrams);
+	}
+
+	TotalWeightGrams += NewGrams - OldGrams;
+}
+
+void UInventoryComponent::SyncItemIndices(UItemObject* ItemObject)
+{
+	if (IsCarried(ItemObject))
+	{
+		ItemObject->OwningInventory = this;
+	}
+	else if (ItemObject->OwningInventory.Get() == this)
+	{
+		ItemObject->OwningInventory.Reset();
+	}
+
+	UpdateOpenStack(ItemObject);
+	PostItemWeight(ItemObject);
+	UpdateItemIndex(ItemObject);
+	UpdateItemHash(ItemObject);
+}
+
+void UInventoryComponent::UpdateOpenStack(UItemObject* ItemObject)
+{
+	const UMasterItemDataAsset* Asset = ItemObject->SourceAsset;
+	if (!Asset || !ItemObject->IsStackable())
+	{
+		return;
+	}
+
+	const bool bOpen = ContainsItem(ItemObject) && ItemObject->Runtime.StackCount < ItemObject->GetMaxStack();
+
+	if (bOpen)
+	{
+		OpenStacks.FindOrAdd(Asset).AddUnique(ItemObject);
+	}
+	else if (TArray<UItemObject*, TInlineAllocator<2>>* Open = OpenStacks.Find(Asset))
+	{
+		Open->RemoveSingle(ItemObject);
+		if (Open->Num() == 0)
+		{
+			OpenStacks.Remove(Asset);
+		}
+	}
+}
+
+
+void UInventoryComponent::UpdateItemIndex(UItemObject* ItemObject)
+{
+	if (ContainsItem(ItemObject))
+	{
+		ItemIndex.Update(ItemObject, GetStackWeightGrams(ItemObject));
+	}
+	else
+	{
+		ItemIndex.Remove(ItemObject);
+	}
+}
+
+
+void UInventoryComponent::UpdateItemHash(const UItemObject* ItemObject)
+{
+	uint64 OldTerm = 0;
+	if (ItemHashTerms.RemoveAndCopyValue(ItemObject, OldTerm))
+	{
+		ContentHash ^= OldTerm;
+	}
+
+	if (const FInventoryItemPlacement* Placement = FindPlacement(ItemObject))
+	{
+		const uint64 Term = FInventoryStateHash::HashPlaced(FInventoryStateHash::HashItem(ItemObject), Placement->TopLeftTile.X, Placement->TopLeftTile.Y);
+		ItemHashTerms.Add(ItemObject, Term);
+		ContentHash ^= Term;
+	}
+	else if (IsCarried(ItemObject))
+	{
+		// Надетый: содержимое входит в вклад его слота (слот + ассет + содержимое) — одинаковые предметы не гасят друг друга
+		OnEquippedItemContentChangedNative.Broadcast(ItemObject);
+	}
+}
+
+void UInventoryComponent::RebuildGridFromPlacements()
+{
+	Cells.Reset();
+	Cells.SetNumZeroed(GetCapacity());
+	ItemTable.Reset();
+	Occupancy.Init(Columns, Rows);
+
+	for (const TPair<TObjectPtr<UItemObject>, FInventoryItemPlacement>& Pair : Placements)
+	{
+		WriteFootprint(Pair.Value, Pair.Key.Get());
+	}
+
+	// Предметы по значению: только занятость, хэндлов у них нет
+	for (const FInventoryStoredItem& Stored : StoredItems)
+	{
+		const FIntRect Rect = Stored.Placement.GetRect();
+		Occupancy.SetRect(Rect.Min.X, Rect.Min.Y, Stored.Placement.Size.X, Stored.Placement.Size.Y, true);
+	}
+}
+
+void UInventoryComponent::WriteFootprint(const FInventoryItemPlacement& Placement, UItemObject* ItemObject)
+{
+	const FIntRect Rect = Placement.GetRect();
+
+	const int32 X0 = FMath::Max(0, Rect.Min.X);
+	const int32 Y0 = FMath::Max(0, Rect.Min.Y);
+	const int32 X1 = FMath::Min(Columns, Rect.Max.X);
+	const int32 Y1 = FMath::Min(Rows, Rect.Max.Y);
+
+	uint16 Handle = FInventoryItemTable::InvalidHandle;
+	if (ItemObject)
+	{
+		Handle = ItemTable.Acquire(ItemObject);
+	}
+	else if (X0 < X1 && Y0 < Y1 && Cells.IsValidIndex(X0 + (Y0 * Columns)))
+	{
+		// Стираем свой прямоугольник -> хэндл предмета лежит в любой его клетке
+		ItemTable.Release(Cells[X0 + (Y0 * Columns)]);
+	}
+
+	for (int32 Y = Y0; Y < Y1; ++Y)
+	{
+		for (int32 X = X0; X < X1; ++X)
+		{
+			const int32 SlotIndex = X + (Y * Columns);
+			if (Cells.IsValidIndex(SlotIndex))
+			{
+				Cells[SlotIndex] = Handle;
+			}
+		}
+	}
+
+	Occupancy.SetRect(Rect.Min.X, Rect.Min.Y, Placement.Size.X, Placement.Size.Y, ItemObject != nullptr);
+}
+
+void UInventoryComponent::EnsureGridStorage()
+{
+	const int32 Cap = GetCapacity();
+	if (Cap <= 0)
+	{
+		return;
+	}
+
+	if (Cells.Num() != Cap || Occupancy.GetColumns() != Columns || Occupancy.GetRows() != Rows)
+	{
+		RebuildGridFromPlacements();
+	}
+}
+
+const FInventoryItemPlacement* UInventoryComponent::FindPlacement(const UItemObject* ItemObject) const
+{
+	// Ключ TMap — TObjectPtr<UItemObject>, поиск по const-указателю ничего не меняет
+	return Placements.Find(const_cast<UItemObject*>(ItemObject));
+}
+
+void UInventoryComponent::NoteItemDelta(UItemObject* ItemObject, bool bStateChanged)
+{
+	if (!IsValid(ItemObject))
+	{
+		return;
+	}
+
+	FInventoryItemDelta* Entry = PendingDeltas.Find(ItemObject);
+	if (!Entry)
+	{
+		// Первое касание за кадр: запоминаем исходное размещение
+		Entry = &PendingDeltas.Add(ItemObject);
+		Entry->Item = ItemObject;
+
+		if (const FInventoryItemPlacement* Placement = FindPlacement(ItemObject))
+		{
+			Entry->bHadPlacement = true;
+			Entry->OldPlacement = *Placement;
+		}
+	}
+
+	Entry->bStateChanged |= bStateChanged;
+	QueueNotify();
+}
+
+void UInventoryComponent::BuildPendingDelta(FInventoryDelta& OutDelta)
+{
+	OutDelta.bFullRefresh = bPendingFullRefresh;
+	OutDelta.Items.Reserve(PendingDeltas.Num());
+
+	for (TPair<TObjectPtr<UItemObject>, FInventoryItemDelta>& Pair : PendingDeltas)
+	{
+		FInventoryItemDelta& Entry = Pair.Value;
+
+		if (const FInventoryItemPlacement* Placement = FindPlacement(Pair.Key))
+		{
+			Entry.bHasPlacement = true;
+			Entry.NewPlacement = *Placement;
+		}
+
+		Entry.bAdded   = !Entry.bHadPlacement && Entry.bHasPlacement;
+		Entry.bRemoved = Entry.bHadPlacement && !Entry.bHasPlacement;
+
+		if (Entry.bHadPlacement && Entry.bHasPlacement)
+		{
+			Entry.bMoved   = Entry.OldPlacement.TopLeftTile.X != Entry.NewPlacement.TopLeftTile.X
+				|| Entry.OldPlacement.TopLeftTile.Y != Entry.NewPlacement.TopLeftTile.Y;
+			Entry.bRotated = Entry.OldPlacement.bRotated != Entry.NewPlacement.bRotated;
+		}
+
+		// Положили и убрали за один кадр / сдвинули туда же — слушателям нечего делать
+		if (!Entry.bAdded && !Entry.bRemoved && !Entry.bMoved && !Entry.bRotated && !Entry.bStateChanged)
+		{
+			continue;
+		}
+
+		OutDelta.Items.Add(Entry);
+	}
+
+	PendingDeltas.Reset();
+	bPendingFullRefresh = false;
+}
+
+int64 UInventoryComponent::GetInstanceWeightGrams(const FItemInstance& Instance)
+{
+	if (!Instance.SourceAsset)
+	{
+		return 0;
+	}
+
+	const int32 Count = FMath::Max(1, Instance.Runtime.StackCount);
+	int64 Total = WeightToGrams(Instance.SourceAsset->ItemDetails.ItemWeight) * Count;
+
+	// Magazine carries ammo weight (у остальных патронов 0)
+	Total += WeightToGrams(Instance.MagazineAmmoUnitWeight) * FMath::Max(0, Instance.MagazineCurrentAmmo);
+
+	// Weapon carries inserted magazine weight
+	if (Instance.bHasInsertedMagazine && Instance.InsertedMagazine.SourceAsset)
+	{
+		const FItemMagazineInstance& Mag = Instance.InsertedMagazine;
+		Total += WeightToGrams(Mag.SourceAsset->ItemDetails.ItemWeight);
+		Total += WeightToGrams(Mag.AmmoUnitWeight) * FMath::Max(0, Mag.CurrentAmmo);
+	}
+
+	return Total;
+}
+
+bool UInventoryComponent::TryAddItemInstance(const FItemInstance& Instance)
+{
+	UMasterItemDataAsset* Asset = Instance.SourceAsset;
+	if (!Asset)
+	{
+		return false;
+	}
+
+	// Инвентарь на экране или нужен откат — сразу нормальный UItemObject
+	const bool bHasListeners = OnInventoryDeltaNative.IsBound() || OnInventoryDelta.IsBound();
+	if (bHasListeners || TransactionDepth > 0)
+	{
+		UItemObject* NewItem = UItemObjectPoolSubsystem::AcquireItem(this, Instance);
+
+		// Все или ничего: TryAddItem мог частично влить стак и не найти места под остаток
+		bool bAdded = false;
+		{
+			FInventoryTransactionScope Transaction(this);
+			bAdded = TryAddItem(NewItem);
+			if (bAdded)
+			{
+				Transaction.Commit();
+			}
+		}
+
+		if (!bAdded)
+		{
+			UItemObjectPoolSubsystem::ReleaseItem(this, NewItem);
+		}
+		return bAdded;
+	}
+
+	const int64 Grams = GetInstanceWeightGrams(Instance);
+	if (!CanTakeAdditionalWeightGrams(Grams))
+	{
+		return false;
+	}
+
+	FItemInstance Remaining = Instance;
+	Remaining.Runtime.StackCount = FMath::Max(1, Instance.Runtime.StackCount);
+
+	// Стакуемое: сколько войдет в хранимые неполные стаки того же ассета (вливаем, только когда все поместится)
+	const bool bStackable = Asset->ItemDetails.bIsStackable;
+	const int32 MaxStack = FMath::Max(1, Asset->ItemDetails.MaxStackCount);
+	if (bStackable)
+	{
+		int32 StackSpace = 0;
+		for (const FInventoryStoredItem& Stored : StoredItems)
+		{
+			if (Stored.Instance.SourceAsset == Asset)
+			{
+				StackSpace += FMath::Max(0, MaxStack - Stored.Instance.Runtime.StackCount);
+			}
+		}
+		Remaining.Runtime.StackCount -= FMath::Min(StackSpace, Remaining.Runtime.StackCount);
+	}
+
+	if (Remaining.Runtime.StackCount > 0)
+	{
+		FInventoryItemPlacement Placement;
+		Placement.Size = FIntPoint(FMath::Max(1, Asset->ItemDetails.Size.X), FMath::Max(1, Asset->ItemDetails.Size.Y));
+		if (Remaining.Runtime.bIsRotated)
+		{
+			Swap(Placement.Size.X, Placement.Size.Y);
+		}
+
+		FIntPoint TopLeft;
+		bool bRotate = false;
+		if (!FInventoryPlacementSolver::FindPlacement(Occupancy, PlacementStrategy, Placement.Size,
+			Asset->ItemDetails.bCanRotate, TopLeft, bRotate))
+		{
+			// Места под остаток нет — ничего не берем
+			return false;
+		}
+
+		if (bRotate)
+		{
+			Remaining.Runtime.bIsRotated = !Remaining.Runtime.bIsRotated;
+			Swap(Placement.Size.X, Placement.Size.Y);
+		}
+
+		Placement.TopLeftTile = FTile(TopLeft.X, TopLeft.Y);
+		Placement.bRotated = Remaining.Runtime.bIsRotated;
+
+		Occupancy.SetRect(TopLeft.X, TopLeft.Y, Placement.Size.X, Placement.Size.Y, true);
+
+		FInventoryStoredItem& Stored = StoredItems.AddDefaulted_GetRef();
+		Stored.Instance = Remaining;
+		Stored.Placement = Placement;
+		ToggleStoredItemHash(Stored);
+	}
+
+	// Остаток лег — теперь вливаем остальное в хранимые стаки
+	int32 ToMerge = FMath::Max(1, Instance.Runtime.StackCount) - Remaining.Runtime.StackCount;
+	for (int32 StoredIndex = 0; bStackable && ToMerge > 0 && StoredIndex < StoredItems.Num(); ++StoredIndex)
+	{
+		FInventoryStoredItem& Stored = StoredItems[StoredIndex];
+		if (Stored.Instance.SourceAsset != Asset || Stored.Instance.Runtime.StackCount >= MaxStack)
+		{
+			continue;
+		}
+
+		const int32 Move = FMath::Min(MaxStack - Stored.Instance.Runtime.StackCount, ToMerge);
+		ToggleStoredItemHash(Stored);
+		Stored.Instance.Runtime.StackCount += Move;
+		ToggleStoredItemHash(Stored);
+		ToMerge -= Move;
+	}
+
+	StoredWeightGrams += Grams;
+	TotalWeightGrams += Grams;
+	MarkInventoryChanged();
+	return true;
+}
+
+void UInventoryComponent::MaterializeItems()
+{
+	if (StoredItems.Num() == 0)
+	{
+		return;
+	}
+
+	// Новые UItemObject попали бы в журнал как "добавленные" и откатились бы вместе с предметами
+	if (!ensureMsgf(TransactionDepth == 0, TEXT("MaterializeItems: called inside a transaction")))
+	{
+		return;
+	}
+
+	// С конца: MaterializeStoredItem вынимает запись, остальные свои клетки держат до своей очереди
+	for (int32 StoredIndex = StoredItems.Num() - 1; StoredIndex >= 0; --StoredIndex)
+	{
+		MaterializeStoredItem(StoredIndex);
+	}
+}
+
+UItemObject* UInventoryComponent::MaterializeItemAt(int32 Index)
+{
+	if (!Cells.IsValidIndex(Index) || StoredItems.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	if (!ensureMsgf(TransactionDepth == 0, TEXT("MaterializeItemAt: called inside a transaction")))
+	{
+		return nullptr;
+	}
+
+	const FIntPoint Cell(Index % Columns, Index / Columns);
+	for (int32 StoredIndex = 0; StoredIndex < StoredItems.Num(); ++StoredIndex)
+	{
+		const FIntRect Rect = StoredItems[StoredIndex].Placement.GetRect();
+		if (Cell.X >= Rect.Min.X && Cell.X < Rect.Max.X && Cell.Y >= Rect.Min.Y && Cell.Y < Rect.Max.Y)
+		{
+			return MaterializeStoredItem(StoredIndex);
+		}
+	}
+
+	return nullptr;
+}
+
+UItemObject* UInventoryComponent::MaterializeStoredItem(int32 StoredIndex)
+{
+	const FInventoryStoredItem Entry = StoredItems[StoredIndex];
+	StoredItems.RemoveAtSwap(StoredIndex);
+
+	// Вклад уходит вместе с записью; UItemObject на том же месте вернет тот же вклад
+	ToggleStoredItemHash(Entry);
+
+	const int64 Grams = GetInstanceWeightGrams(Entry.Instance);
+	StoredWeightGrams -= Grams;
+	TotalWeightGrams -= Grams;
+
+	// Снимаем занятость записи — дальше ее клетки займет UItemObject
+	const FIntRect Rect = Entry.Placement.GetRect();
+	Occupancy.SetRect(Rect.Min.X, Rect.Min.Y, Rect.Width(), Rect.Height(), false);
+
+	UItemObject* Item = UItemObjectPoolSubsystem::AcquireItem(this, Entry.Instance);
+
+	const int32 TopLeftIndex = TileToIndex(Entry.Placement.TopLeftTile);
+	const bool bPlacedBack = TopLeftIndex != INDEX_NONE && IsRoomAvailable(Item, TopLeftIndex) && AddItemAt(Item, TopLeftIndex);
+	if (!bPlacedBack && !TryAddItem(Item))
+	{
+		UE_LOG(LogInventory, Warning, TEXT("MaterializeItems: no room for %s, item lost"), *GetNameSafe(Entry.Instance.SourceAsset));
+		UItemObjectPoolSubsystem::ReleaseItem(this, Item);
+		MarkInventoryChanged();
+		return nullptr;
+	}
+
+	// TryAddItem мог целиком влить стак в соседние — пустой объект не лег в грид, отпускаем его
+	if (!bPlacedBack && !ContainsItem(Item))
+	{
+		UItemObjectPoolSubsystem::ReleaseItem(this, Item);
+		return nullptr;
+	}
+
+	return Item;
+}
+
+void UInventoryComponent::DehydrateItems()
+{
+	// Во время транзакции/сортировки предметы держат журнал и снимок
+	if (TransactionDepth > 0 || bSortInProgress || Placements.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<UItemObject*> Released;
+	Released.Reserve(Placements.Num());
+	StoredItems.Reserve(StoredItems.Num() + Placements.Num());
+
+	for (const TPair<TObjectPtr<UItemObject>, FInventoryItemPlacement>& Pair : Placements)
+	{
+		UItemObject* Item = Pair.Key.Get();
+		if (!IsValid(Item))
+		{
+			continue;
+		}
+
+		// Переопределенные конфиги в FItemInstance не помещаются — такие предметы остаются UItemObject
+		const UItemObject* Mag = Item->GetInsertedMagazine();
+		if (Item->HasConfigOverrides() || (Mag && Mag->HasConfigOverrides()))
+		{
+			continue;
+		}
+
+		FInventoryStoredItem& Stored = StoredItems.AddDefaulted_GetRef();
+		Stored.Instance = Item->MakeInstance();
+		Stored.Placement = Pair.Value;
+		ToggleStoredItemHash(Stored);
+
+		StoredWeightGrams += GetStackWeightGrams(Item);
+		Released.Add(Item);
+	}
+
+	if (Released.Num() == 0)
+	{
+		return;
+	}
+
+	for (UItemObject* Item : Released)
+	{
+		Placements.Remove(Item);
+	}
+
+	// Индексы/журнал веса отпускают предметы (вес уже перенесен в StoredWeightGrams)
+	for (UItemObject* Item : Released)
+	{
+		SyncItemIndices(Item);
+	}
+	InvalidateWeight();
+
+	// Состояние уже в StoredItems — объекты больше не нужны
+	for (UItemObject* Item : Released)
+	{
+		UItemObjectPoolSubsystem::ReleaseItem(this, Item);
+	}
+
+	RebuildGridFromPlacements();
+	bPendingFullRefresh = true;
+	MarkInventoryChanged();
+}
+
+
+namespace InventoryTransfer
+{
+	/** Шаг плана: сколько влить в какие стаки цели и куда положить остаток. */
+	struct FStep
+	{
+		UItemObject* Item = nullptr;
+		TArray<TPair<UItemObject*, int32>, TInlineAllocator<2>> Merges;
+		int32 MergedUnits = 0;
+
+		bool bPlace = false;
+		int32 TopLeftIndex = INDEX_NONE;
+		bool bRotate = false;
+	};
+
+	/** Стак цели и свободное место в нем с учетом уже запланированного. */
+	struct FOpenStack
+	{
+		UItemObject* Stack = nullptr;
+		int32 Space = 0;
+	};
+}
+
+FInventoryTransferResult UInventoryComponent::TransferAllTo(UInventoryComponent* Target)
+{
+	// Переносятся только UItemObject грида
+	MaterializeItems();
+	return TransferItemsTo(Target, GetAllItems());
+}
+
+FInventoryTransferResult UInventoryComponent::TransferItemsTo(UInventoryComponent* Target, const TArray<UItemObject*>& Items)
+{
+	using namespace InventoryTransfer;
+
+	FInventoryTransferResult Result;
+
+	// Кандидаты: только предметы нашего грида, без дублей, крупные вперед
+	TArray<UItemObject*> Candidates;
+	Candidates.Reserve(Items.Num());
+	for (UItemObject* Item : Items)
+	{
+		if (IsValid(Item) && ContainsItem(Item) && !Candidates.Contains(Item))
+		{
+			Candidates.Add(Item);
+		}
+	}
+
+	if (!IsValid(Target) || Target == this || Target->GetCapacity() <= 0)
+	{
+		Result.NotMoved.Append(Candidates);
+		return Result;
+	}
+
+	Candidates.StableSort([](const UItemObject& A, const UItemObject& B)
+	{
+		const FItemSize& SizeA = A.GetItemDetails().Size;
+		const FItemSize& SizeB = B.GetItemDetails().Size;
+		return SizeA.X * SizeA.Y > SizeB.X * SizeB.Y;
+	});
+
+	Target->EnsureGridStorage();
+
+	// ===== 1) План на копиях: занятость, вес, стаки цели =====
+	FInventoryOccupancyGrid PlanGrid = Target->Occupancy;
+
+	int64 FreeGrams = MAX_int64;
+
+	// Каждый положенный целым предмет занимает хэндл в таблице клеток цели
+	int32 FreeHandles = FInventoryItemTable::MaxItems - Target->ItemTable.Num();
+	if (Target->GetMaxCarryWeight() > 0.f)
+	{
+		FreeGrams = FMath::Max<int64>(0, WeightToGrams(Target->GetMaxCarryWeight()) - Target->TotalWeightGrams);
+	}
+
+	TMap<const UMasterItemDataAsset*, TArray<FOpenStack, TInlineAllocator<2>>> PlanOpen;
+	TArray<FStep> Steps;
+	Steps.Reserve(Candidates.Num());
+
+	for (UItemObject* Item : Candidates)
+	{
+		FStep& Step = Steps.AddDefaulted_GetRef();
+		Step.Item = Item;
+
+		int32 Remaining = FMath::Max(1, Item->Runtime.StackCount);
+
+		// Стакуемое: сперва в неполные стаки цели (и в уже запланированные на перенос)
+		if (Item->IsStackable() && Item->GetMaxStack() > 1 && Item->SourceAsset)
+		{
+			const int64 UnitGrams = WeightToGrams(Item->GetItemDetails().ItemWeight);
+
+			TArray<FOpenStack, TInlineAllocator<2>>* Open = PlanOpen.Find(Item->SourceAsset);
+			if (!Open)
+			{
+				Open = &PlanOpen.Add(Item->SourceAsset);
+				if (const TArray<UItemObject*, TInlineAllocator<2>>* TargetOpen = Target->OpenStacks.Find(Item->SourceAsset))
+				{
+					for (UItemObject* Stack : *TargetOpen)
+					{
+						Open->Add({ Stack, FMath::Max(0, Stack->GetMaxStack() - FMath::Max(1, Stack->Runtime.StackCount)) });
+					}
+				}
+			}
+
+			for (FOpenStack& Entry : *Open)
+			{
+				const int64 ByWeight = UnitGrams > 0 ? FreeGrams / UnitGrams : MAX_int32;
+				const int32 Add = static_cast<int32>(FMath::Min<int64>(FMath::Min(Entry.Space, Remaining), ByWeight));
+				if (Add <= 0)
+				{
+					continue;
+				}
+
+				Step.Merges.Emplace(Entry.Stack, Add);
+				Step.MergedUnits += Add;
+				Entry.Space -= Add;
+				Remaining -= Add;
+				FreeGrams -= UnitGrams * Add;
+
+				if (Remaining <= 0)
+				{
+					break;
+				}
+			}
+		}
+
+		Result.NumMergedUnits += Step.MergedUnits;
+
+		if (Remaining <= 0)
+		{
+			continue;
+		}
+
+		// Остаток — целым предметом в грид
+		const int64 RemainingGrams = Step.MergedUnits > 0
+			? WeightToGrams(Item->GetItemDetails().ItemWeight) * Remaining
+			: GetStackWeightGrams(Item);
+		if (RemainingGrams > FreeGrams || FreeHandles <= 0)
+		{
+			continue;
+		}
+
+		const FIntPoint Size = GetEffectiveItemSize(Item);
+		FIntPoint TopLeft;
+		if (!FInventoryPlacementSolver::FindPlacement(PlanGrid, Target->PlacementStrategy, Size,
+			Item->GetItemDetails().bCanRotate, TopLeft, Step.bRotate))
+		{
+			continue;
+		}
+
+		const FIntPoint Placed = Step.bRotate ? FIntPoint(Size.Y, Size.X) : Size;
+		PlanGrid.SetRect(TopLeft.X, TopLeft.Y, Placed.X, Placed.Y, true);
+		FreeGrams -= RemainingGrams;
+		--FreeHandles;
+
+		Step.bPlace = true;
+		Step.TopLeftIndex = TopLeft.X + (TopLeft.Y * Target->Columns);
+
+		// Положенный неполный стак принимает следующие такие же предметы
+		if (Item->IsStackable() && Remaining < Item->GetMaxStack())
+		{
+			PlanOpen.FindOrAdd(Item->SourceAsset).Add({ Item, Item->GetMaxStack() - Remaining });
+		}
+	}
+
+	// ===== 2) Применение: обе стороны в транзакции, по одному уведомлению на сторону =====
+	TArray<UItemObject*> FullyMerged;
+	{
+		FInventoryTransactionScope SourceTransaction(this);
+		FInventoryTransactionScope TargetTransaction(Target);
+
+		for (const FStep& Step : Steps)
+		{
+			UItemObject* Item = Step.Item;
+			const int32 Count = FMath::Max(1, Item->Runtime.StackCount);
+
+			// Журналы обеих сторон видят исходное состояние предмета
+			RecordItemState(Item);
+			Target->RecordItemState(Item);
+
+			for (const TPair<UItemObject*, int32>& Merge : Step.Merges)
+			{
+				Target->RecordItemState(Merge.Key);
+				Merge.Key->SetStackCount(FMath::Max(1, Merge.Key->Runtime.StackCount) + Merge.Value);
+			}
+
+			const int32 Remaining = Count - Step.MergedUnits;
+			if (Remaining <= 0)
+			{
+				RemoveItem(Item);
+				FullyMerged.Add(Item);
+				++Result.NumMoved;
+				continue;
+			}
+
+			if (Step.MergedUnits > 0)
+			{
+				Item->SetStackCount(Remaining);
+			}
+
+			if (!Step.bPlace)
+			{
+				Result.NotMoved.Add(Item);
+				continue;
+			}
+
+			RemoveItem(Item);
+			Item->Runtime.bIsRotated ^= Step.bRotate;
+
+			// План считался на копии занятости цели — расхождение значит ошибку планировщика.
+			// Выход без Commit: скоупы откатывают обе стороны целиком
+			if (!ensureMsgf(Target->IsRoomAvailable(Item, Step.TopLeftIndex) && Target->AddItemAt(Item, Step.TopLeftIndex),
+				TEXT("TransferItemsTo: planned cell %d is not free"), Step.TopLeftIndex))
+			{
+				Result = FInventoryTransferResult();
+				Result.NotMoved.Append(Candidates);
+				return Result;
+			}
+
+			++Result.NumMoved;
+		}
+
+		TargetTransaction.Commit();
+		SourceTransaction.Commit();
+	}
+
+	// Полностью влитые объекты больше никому не нужны (в чужой транзакции их может вернуть откат)
+	if (TransactionDepth == 0)
+	{
+		for (UItemObject* Item : FullyMerged)
+		{
+			UItemObjectPoolSubsystem::ReleaseItem(this, Item);
+		}
+	}
+
+	return Result;
+}
+
+bool UInventoryComponent::RequestSort(float TimeBudgetSeconds)
+{
+	if (bSortInProgress)
+	{
+		return false;
+	}
+
+	// Решатель раскладывает только UItemObject
+	MaterializeItems();
+
+	if (Placements.Num() == 0)
+	{
+		return false;
+	}
+
+	// Снимок: только данные, в фоне UObject не трогаем
+	FInventorySortRequest Request;
+	Request.Columns = Columns;
+	Request.Rows = Rows;
+	Request.TimeBudgetSeconds = FMath::Max(0.f, TimeBudgetSeconds);
+	Request.RandomSeed = ContentVersion;
+	Request.Items.Reserve(Placements.Num());
+
+	SortSnapshotItems.Reset(Placements.Num());
+
+	TMap<const UMasterItemDataAsset*, int32> StackGroups;
+
+	for (const TPair<TObjectPtr<UItemObject>, FInventoryItemPlacement>& Pair : Placements)
+	{
+		UItemObject* Item = Pair.Key.Get();
+		if (!IsValid(Item))
+		{
+			continue;
+		}
+
+		FInventorySortItem& Entry = Request.Items.AddDefaulted_GetRef();
+		Entry.Size = FIntPoint(FMath::Max(1, Item->GetItemDetails().Size.X), FMath::Max(1, Item->GetItemDetails().Size.Y));
+		Entry.bCanRotate = Item->GetItemDetails().bCanRotate;
+		Entry.Category = static_cast<uint8>(Item->GetItemDetails().ItemCategory);
+		Entry.SubCategory = static_cast<uint8>(Item->GetItemDetails().ItemSubCategory);
+		Entry.ItemID = Item->GetItemDetails().ItemID;
+		Entry.StackCount = FMath::Max(1, Item->Runtime.StackCount);
+		Entry.MaxStack = FMath::Max(1, Item->GetMaxStack());
+
+		// Стакуются только предметы одного SourceAsset (как в TryAddItem)
+		if (Item->IsStackable() && Item->SourceAsset)
+		{
+			Entry.StackGroup = StackGroups.FindOrAdd(Item->SourceAsset, StackGroups.Num());
+		}
+
+		SortSnapshotItems.Add(Item);
+	}
+
+	bSortInProgress = true;
+	SortSnapshotVersion = ContentVersion;
+
+	TWeakObjectPtr<UInventoryComponent> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Request = MoveTemp(Request)]()
+	{
+		FInventorySortResult Result = FInventorySortSolver::Solve(Request);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Result = MoveTemp(Result)]()
+		{
+			if (UInventoryComponent* Inventory = WeakThis.Get())
+			{
+				Inventory->ApplySortResult(Result);
+			}
+		});
+	});
+
+	return true;
+}
+
+void UInventoryComponent::ApplySortResult(const FInventorySortResult& Result)
+{
+	bSortInProgress = false;
+
+	const TArray<TWeakObjectPtr<UItemObject>> SnapshotItems = MoveTemp(SortSnapshotItems);
+	SortSnapshotItems.Reset();
+
+	// Пока шел расчет инвентарь поменялся — снимок устарел
+	if (!Result.bSuccess || SortSnapshotVersion != ContentVersion || Result.Placements.Num() != SnapshotItems.Num())
+	{
+		OnInventorySortedNative.Broadcast(false);
+
+		if (OnInventorySorted.IsBound())
+		{
+			OnInventorySorted.Broadcast(false);
+		}
+		return;
+	}
+
+	bool bApplied = true;
+
+	// Снимаем всё и раскладываем заново — одна транзакция, одно уведомление
+	{
+		FInventoryTransactionScope Transaction(this);
+
+		for (const TWeakObjectPtr<UItemObject>& WeakItem : SnapshotItems)
+		{
+			RemoveItem(WeakItem.Get());
+		}
+
+		for (int32 i = 0; i < SnapshotItems.Num() && bApplied; ++i)
+		{
+			UItemObject* Item = SnapshotItems[i].Get();
+			if (!IsValid(Item))
+			{
+				continue;
+			}
+
+			// Стак целиком влит в другие — предмет из инвентаря уходит
+			const int32 NewCount = Result.StackCounts[i];
+			if (NewCount <= 0)
+			{
+				continue;
+			}
+
+			const FInventorySortPlacement& Placement = Result.Placements[i];
+
+			Item->SetStackCount(NewCount);
+			Item->Runtime.bIsRotated = Placement.bRotated;
+			if (!AddItemAt(Item, Placement.X + (Placement.Y * Columns)))
+			{
+				UE_LOG(LogInventory, Warning, TEXT("ApplySortResult: %s does not fit, sort rolled back"), *GetNameSafe(Item));
+				bApplied = false; // откат вернет прежнюю раскладку
+			}
+		}
+
+		if (bApplied)
+		{
+			MarkInventoryChanged();
+			Transaction.Commit();
+		}
+	}
+
+	OnInventorySortedNative.Broadcast(bApplied);
+
+	if (OnInventorySorted.IsBound())
+	{
+		OnInventorySorted.Broadcast(bApplied);
+	}
+}
+
+void UInventoryComponent::BeginTransaction()
+{
+	if (TransactionDepth++ == 0)
+	{
+		bTransactionAborted = false;
+		bTransactionChanged = false;
+		TransactionJournal.Reset();
+	}
+}
+
+void UInventoryComponent::CommitTransaction()
+{
+	if (TransactionDepth <= 0)
+	{
+		UE_LOG(LogInventory, Warning, TEXT("CommitTransaction without BeginTransaction on %s"), *GetNameSafe(GetOwner()));
+		return;
+	}
+
+	if (--TransactionDepth > 0)
+	{
+		return;
+	}
+
+	if (bTransactionAborted)
+	{
+		RollbackTransaction();
+	}
+
+	TransactionJournal.Reset();
+
+	if (bTransactionChanged)
+	{
+		bTransactionChanged = false;
+		MarkInventoryChanged();
+	}
+}
+
+void UInventoryComponent::AbortTransaction()
+{
+	if (TransactionDepth <= 0)
+	{
+		UE_LOG(LogInventory, Warning, TEXT("AbortTransaction without BeginTransaction on %s"), *GetNameSafe(GetOwner()));
+		return;
+	}
+
+	// Вложенный Abort откатывает всю внешнюю транзакцию
+	bTransactionAborted = true;
+	CommitTransaction();
+}
+
+void UInventoryComponent::RecordItemState(UItemObject* ItemObject)
+{
+	if (TransactionDepth <= 0 || !IsValid(ItemObject) || TransactionJournal.Contains(ItemObject))
+	{
+		return;
+	}
+
+	FInventoryTransactionEntry& Entry = TransactionJournal.Add(ItemObject);
+	Entry.State = ItemObject->MakeSnapshot();
+
+	if (const FInventoryItemPlacement* Placement = FindPlacement(ItemObject))
+	{
+		Entry.Placement = *Placement;
+	}
+}
+
+void UInventoryComponent::RollbackTransaction()
+{
+	// 1) Стираем текущие клетки затронутых предметов (старые и новые места могли пересекаться)
+	for (const TPair<UItemObject*, FInventoryTransactionEntry>& Pair : TransactionJournal)
+	{
+		NoteItemDelta(Pair.Key, true);
+
+		FInventoryItemPlacement Current;
+		if (Placements.RemoveAndCopyValue(Pair.Key, Current))
+		{
+			WriteFootprint(Current, nullptr);
+		}
+	}
+
+	// 2) Состояние предметов (стак / магазин / поворот)
+	for (const TPair<UItemObject*, FInventoryTransactionEntry>& Pair : TransactionJournal)
+	{
+		if (IsValid(Pair.Key))
+		{
+			Pair.Key->RestoreSnapshot(Pair.Value.State);
+		}
+	}
+
+	// 3) Размещения и индексы
+	for (const TPair<UItemObject*, FInventoryTransactionEntry>& Pair : TransactionJournal)
+	{
+		UItemObject* Item = Pair.Key;
+		if (!IsValid(Item))
+		{
+			continue;
+		}
+
+		if (Pair.Value.Placement.IsSet())
+		{
+			Placements.Add(Item, Pair.Value.Placement.GetValue());
+			WriteFootprint(Pair.Value.Placement.GetValue(), Item);
+		}
+
+		SyncItemIndices(Item);
+	}
+
+	// UI мог увидеть промежуточное состояние через события экипировки
+	bTransactionChanged = true;
+}
+
+// ===== FInventoryTransactionScope =====
+
+FInventoryTransactionScope::FInventoryTransactionScope(UInventoryComponent* InInventory)
+	: Inventory(InInventory)
+{
+	if (IsValid(Inventory))
+	{
+		Inventory->BeginTransaction();
+	}
+}
+
+FInventoryTransactionScope::~FInventoryTransactionScope()
+{
+	if (!bFinished && IsValid(Inventory))
+	{
+		Inventory->AbortTransaction();
+	}
+}
+
+void FInventoryTransactionScope::Commit()
+{
+	if (!bFinished && IsValid(Inventory))
+	{
+		Inventory->CommitTransaction();
 	}
 
-	// В нашем проекте самый безопасный ключ — SourceAsset
-	return A->SourceAsset == B->SourceAsset;
+	bFinished = true;
 }
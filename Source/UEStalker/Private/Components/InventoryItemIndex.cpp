@@ -0,0 +1,240 @@
+#include "Components/InventoryItemIndex.h"
+#include "Items/ItemObject.h"
+#include "Algo/BinarySearch.h"
+
+namespace InventoryItemIndex
+{
+	template <typename KeyType>
+	static void AddToBucket(TMap<KeyType, TArray<UItemObject*>>& Buckets, KeyType Key, UItemObject* Item)
+	{
+		Buckets.FindOrAdd(Key).Add(Item);
+	}
+
+	template <typename KeyType>
+	static void RemoveFromBucket(TMap<KeyType, TArray<UItemObject*>>& Buckets, KeyType Key, const UItemObject* Item)
+	{
+		if (TArray<UItemObject*>* Bucket = Buckets.Find(Key))
+		{
+			Bucket->RemoveSingleSwap(const_cast<UItemObject*>(Item));
+			if (Bucket->Num() == 0)
+			{
+				Buckets.Remove(Key);
+			}
+		}
+	}
+}
+
+void FInventoryItemIndex::Reset()
+{
+	Keys.Reset();
+	ByCategory.Reset();
+	ByFilter.Reset();
+	SortedByCategory.Reset();
+
+	for (TArray<FEntry>& View : Sorted)
+	{
+		View.Reset();
+	}
+}
+
+void FInventoryItemIndex::Update(UItemObject* Item, int64 WeightGrams)
+{
+	if (!Item)
+	{
+		return;
+	}
+
+	const FItemKeys NewKeys = MakeKeys(Item, WeightGrams);
+
+	FItemKeys* OldKeys = Keys.Find(Item);
+	if (!OldKeys)
+	{
+		InventoryItemIndex::AddToBucket(ByCategory, NewKeys.Category, Item);
+		InventoryItemIndex::AddToBucket(ByFilter, NewKeys.Filter, Item);
+
+		for (int32 SortIdx = 0; SortIdx < NumSortKeys; ++SortIdx)
+		{
+			InsertSorted(Sorted[SortIdx], MakeEntry(NewKeys, SortIdx, Item));
+		}
+		AddToCategoryViews(NewKeys, Item);
+
+		Keys.Add(Item, NewKeys);
+		return;
+	}
+
+	const bool bCategoryChanged = OldKeys->Category != NewKeys.Category;
+	if (bCategoryChanged)
+	{
+		InventoryItemIndex::RemoveFromBucket(ByCategory, OldKeys->Category, Item);
+		InventoryItemIndex::AddToBucket(ByCategory, NewKeys.Category, Item);
+
+		RemoveFromCategoryViews(*OldKeys, Item);
+		AddToCategoryViews(NewKeys, Item);
+	}
+
+	if (OldKeys->Filter != NewKeys.Filter)
+	{
+		InventoryItemIndex::RemoveFromBucket(ByFilter, OldKeys->Filter, Item);
+		InventoryItemIndex::AddToBucket(ByFilter, NewKeys.Filter, Item);
+	}
+
+	// Переставляем только виды, где ключ поменялся (обычно это вес/цена после смены стака)
+	const bool bNameChanged = OldKeys->Name != NewKeys.Name;
+	FSortedViews* CategoryViews = bCategoryChanged ? nullptr : SortedByCategory.Find(NewKeys.Category);
+
+	for (int32 SortIdx = 0; SortIdx < NumSortKeys; ++SortIdx)
+	{
+		if (bNameChanged || OldKeys->Sort[SortIdx] != NewKeys.Sort[SortIdx])
+		{
+			const FEntry OldEntry = MakeEntry(*OldKeys, SortIdx, Item);
+			const FEntry NewEntry = MakeEntry(NewKeys, SortIdx, Item);
+
+			RemoveSorted(Sorted[SortIdx], OldEntry);
+			InsertSorted(Sorted[SortIdx], NewEntry);
+
+			// При смене категории виды категорий уже пересобраны с новыми ключами
+			if (CategoryViews)
+			{
+				RemoveSorted(CategoryViews->Views[SortIdx], OldEntry);
+				InsertSorted(CategoryViews->Views[SortIdx], NewEntry);
+			}
+		}
+	}
+
+	*OldKeys = NewKeys;
+}
+
+void FInventoryItemIndex::Remove(const UItemObject* Item)
+{
+	FItemKeys OldKeys;
+	if (!Keys.RemoveAndCopyValue(Item, OldKeys))
+	{
+		return;
+	}
+
+	InventoryItemIndex::RemoveFromBucket(ByCategory, OldKeys.Category, Item);
+	InventoryItemIndex::RemoveFromBucket(ByFilter, OldKeys.Filter, Item);
+
+	for (int32 SortIdx = 0; SortIdx < NumSortKeys; ++SortIdx)
+	{
+		RemoveSorted(Sorted[SortIdx], MakeEntry(OldKeys, SortIdx, Item));
+	}
+	RemoveFromCategoryViews(OldKeys, Item);
+}
+
+void FInventoryItemIndex::GetSorted(EInventorySortKey SortKey, bool bDescending, TArray<UItemObject*>& OutItems) const
+{
+	CopyView(Sorted[FMath::Clamp(static_cast<int32>(SortKey), 0, NumSortKeys - 1)], bDescending, OutItems);
+}
+
+void FInventoryItemIndex::GetSortedInCategory(EInventorySortKey SortKey, bool bDescending, EItemCategory Category, TArray<UItemObject*>& OutItems) const
+{
+	const FSortedViews* CategoryViews = SortedByCategory.Find(Category);
+	if (!CategoryViews)
+	{
+		OutItems.Reset();
+		return;
+	}
+
+	CopyView(CategoryViews->Views[FMath::Clamp(static_cast<int32>(SortKey), 0, NumSortKeys - 1)], bDescending, OutItems);
+}
+
+void FInventoryItemIndex::CopyView(const TArray<FEntry>& View, bool bDescending, TArray<UItemObject*>& OutItems)
+{
+	OutItems.Reset(View.Num());
+	if (bDescending)
+	{
+		for (int32 i = View.Num() - 1; i >= 0; --i)
+		{
+			OutItems.Add(View[i].Item);
+		}
+	}
+	else
+	{
+		for (const FEntry& Entry : View)
+		{
+			OutItems.Add(Entry.Item);
+		}
+	}
+}
+
+bool FInventoryItemIndex::EntryLess(const FEntry& A, const FEntry& B)
+{
+	if (A.Key != B.Key)
+	{
+		return A.Key < B.Key;
+	}
+
+	if (A.Name != B.Name)
+	{
+		return A.Name.LexicalLess(B.Name);
+	}
+
+	return A.Item < B.Item;
+}
+
+FInventoryItemIndex::FItemKeys FInventoryItemIndex::MakeKeys(const UItemObject* Item, int64 WeightGrams)
+{
+	const FMasterItemDetails& Details = Item->GetItemDetails();
+	const int32 StackCount = FMath::Max(1, Item->Runtime.StackCount);
+
+	FItemKeys Result;
+	Result.Category = Details.ItemCategory;
+	Result.Filter = Details.ItemFilter;
+	Result.Name = Details.ItemName;
+
+	Result.Sort[static_cast<int32>(EInventorySortKey::Weight)] = WeightGrams;
+
+	// Цена в копейках — целый ключ без сюрпризов float-сравнения
+	Result.Sort[static_cast<int32>(EInventorySortKey::Value)] =
+		FMath::RoundToInt64(static_cast<double>(Item->GetTradeConfig().ItemCostSell) * StackCount * 100.0);
+
+	Result.Sort[static_cast<int32>(EInventorySortKey::Size)] =
+		static_cast<int64>(FMath::Max(1, Details.Size.X)) * FMath::Max(1, Details.Size.Y);
+
+	Result.Sort[static_cast<int32>(EInventorySortKey::Name)] = 0;
+
+	return Result;
+}
+
+void FInventoryItemIndex::InsertSorted(TArray<FEntry>& View, const FEntry& Entry)
+{
+	View.Insert(Entry, Algo::LowerBound(View, Entry, &FInventoryItemIndex::EntryLess));
+}
+
+void FInventoryItemIndex::RemoveSorted(TArray<FEntry>& View, const FEntry& Entry)
+{
+	const int32 Pos = Algo::LowerBound(View, Entry, &FInventoryItemIndex::EntryLess);
+	if (ensureMsgf(View.IsValidIndex(Pos) && View[Pos].Item == Entry.Item, TEXT("FInventoryItemIndex: sorted view out of sync")))
+	{
+		View.RemoveAt(Pos);
+	}
+}
+
+void FInventoryItemIndex::AddToCategoryViews(const FItemKeys& ItemKeys, const UItemObject* Item)
+{
+	FSortedViews& CategoryViews = SortedByCategory.FindOrAdd(ItemKeys.Category);
+	for (int32 SortIdx = 0; SortIdx < NumSortKeys; ++SortIdx)
+	{
+		InsertSorted(CategoryViews.Views[SortIdx], MakeEntry(ItemKeys, SortIdx, Item));
+	}
+}
+
+void FInventoryItemIndex::RemoveFromCategoryViews(const FItemKeys& ItemKeys, const UItemObject* Item)
+{
+	FSortedViews* CategoryViews = SortedByCategory.Find(ItemKeys.Category);
+	if (!CategoryViews)
+	{
+		return;
+	}
+
+	for (int32 SortIdx = 0; SortIdx < NumSortKeys; ++SortIdx)
+	{
+		RemoveSorted(CategoryViews->Views[SortIdx], MakeEntry(ItemKeys, SortIdx, Item));
+	}
+
+	if (CategoryViews->Views[0].Num() == 0)
+	{
+		SortedByCategory.Remove(ItemKeys.Category);
+	}
+}
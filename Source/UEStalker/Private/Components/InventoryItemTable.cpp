@@ -0,0 +1,73 @@
+#include "Components/InventoryItemTable.h"
+
+void FInventoryItemTable::Reset()
+{
+	// Поколения не сбрасываем: хэндлы, пережившие Reset, должны остаться невалидными
+	for (int32 i = 0; i < Slots.Num(); ++i)
+	{
+		if (Slots[i] != nullptr)
+		{
+			Slots[i] = nullptr;
+			Generations[i] = static_cast<uint8>((Generations[i] + 1) & GenerationMask);
+		}
+	}
+
+	FreeSlots.Reset();
+	for (int32 i = Slots.Num() - 1; i >= 0; --i)
+	{
+		FreeSlots.Add(static_cast<uint16>(i));
+	}
+
+	NumUsed = 0;
+}
+
+uint16 FInventoryItemTable::Acquire(UItemObject* Item)
+{
+	if (!Item || IsFull())
+	{
+		return InvalidHandle;
+	}
+
+	int32 Slot = INDEX_NONE;
+	if (FreeSlots.Num() > 0)
+	{
+		Slot = FreeSlots.Pop();
+	}
+	else
+	{
+		Slot = Slots.Add(nullptr);
+		Generations.Add(0);
+	}
+
+	Slots[Slot] = Item;
+	++NumUsed;
+
+	return static_cast<uint16>((Generations[Slot] << IndexBits) | (Slot + 1));
+}
+
+void FInventoryItemTable::Release(uint16 Handle)
+{
+	if (!IsValidHandle(Handle))
+	{
+		return;
+	}
+
+	const int32 Slot = HandleSlot(Handle);
+	Slots[Slot] = nullptr;
+	Generations[Slot] = static_cast<uint8>((Generations[Slot] + 1) & GenerationMask);
+	FreeSlots.Add(static_cast<uint16>(Slot));
+	--NumUsed;
+}
+
+UItemObject* FInventoryItemTable::Resolve(uint16 Handle) const
+{
+	return IsValidHandle(Handle) ? Slots[HandleSlot(Handle)] : nullptr;
+}
+
+bool FInventoryItemTable::IsValidHandle(uint16 Handle) const
+{
+	const int32 Slot = HandleSlot(Handle);
+	return Slots.IsValidIndex(Slot)
+		&& Slots[Slot] != nullptr
+		&& Generations[Slot] == HandleGeneration(Handle);
+}
@@ -0,0 +1,46 @@
+#include "Components/InventoryNotifySubsystem.h"
+#include "Components/InventoryComponent.h"
+
+namespace InventoryNotify
+{
+	// Рассылка может снова пометить инвентарь (перенос между контейнерами из обработчика) —
+	// дорассылаем в этом же кадре, но без бесконечного цикла
+	static constexpr int32 MaxFlushPasses = 4;
+}
+
+void UInventoryNotifySubsystem::QueueInventory(UInventoryComponent* Inventory)
+{
+	if (IsValid(Inventory))
+	{
+		Queued.Add(Inventory);
+	}
+}
+
+void UInventoryNotifySubsystem::FlushQueued()
+{
+	for (int32 Pass = 0; Pass < InventoryNotify::MaxFlushPasses && Queued.Num() > 0; ++Pass)
+	{
+		TArray<TWeakObjectPtr<UInventoryComponent>> Batch = MoveTemp(Queued);
+		Queued.Reset();
+
+		for (const TWeakObjectPtr<UInventoryComponent>& Weak : Batch)
+		{
+			if (UInventoryComponent* Inventory = Weak.Get())
+			{
+				Inventory->FlushNotifications();
+			}
+		}
+	}
+}
+
+void UInventoryNotifySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushQueued();
+}
+
+TStatId UInventoryNotifySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInventoryNotifySubsystem, STATGROUP_Tickables);
+}
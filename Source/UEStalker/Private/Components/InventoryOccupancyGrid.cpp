@@ -0,0 +1,236 @@
+#include "Components/InventoryOccupancyGrid.h"
+
+void FInventoryOccupancyGrid::Init(int32 InColumns, int32 InRows)
+{
+	Columns = FMath::Max(0, InColumns);
+	Rows    = FMath::Max(0, InRows);
+	WordsPerRow = (Columns + 63) / 64;
+
+	Bits.Reset();
+	Bits.SetNumZeroed(WordsPerRow * Rows);
+}
+
+void FInventoryOccupancyGrid::Reset()
+{
+	FMemory::Memzero(Bits.GetData(), Bits.Num() * sizeof(uint64));
+}
+
+bool FInventoryOccupancyGrid::IsOccupied(int32 X, int32 Y) const
+{
+	if (X < 0 || Y < 0 || X >= Columns || Y >= Rows)
+	{
+		return false;
+	}
+
+	return (RowPtr(Y)[X >> 6] & (1ull << (X & 63))) != 0;
+}
+
+void FInventoryOccupancyGrid::SetRect(int32 X, int32 Y, int32 W, int32 H, bool bOccupied)
+{
+	// Клипаем по гриду
+	const int32 X0 = FMath::Max(0, X);
+	const int32 Y0 = FMath::Max(0, Y);
+	const int32 X1 = FMath::Min(Columns, X + W);
+	const int32 Y1 = FMath::Min(Rows, Y + H);
+
+	if (X0 >= X1 || Y0 >= Y1)
+	{
+		return;
+	}
+
+	const int32 FirstWord = X0 >> 6;
+	const int32 LastWord  = (X1 - 1) >> 6;
+
+	for (int32 RowY = Y0; RowY < Y1; ++RowY)
+	{
+		uint64* Row = RowPtr(RowY);
+
+		for (int32 WordIdx = FirstWord; WordIdx <= LastWord; ++WordIdx)
+		{
+			const int32 Base = WordIdx << 6;
+			const uint64 Mask = SpanMask(FMath::Max(X0, Base) - Base, FMath::Min(X1, Base + 64) - Base);
+
+			if (bOccupied)
+			{
+				Row[WordIdx] |= Mask;
+			}
+			else
+			{
+				Row[WordIdx] &= ~Mask;
+			}
+		}
+	}
+}
+
+bool FInventoryOccupancyGrid::IsRectFree(int32 X, int32 Y, int32 W, int32 H) const
+{
+	if (!IsRectInBounds(X, Y, W, H))
+	{
+		return false;
+	}
+
+	const int32 X1 = X + W;
+	const int32 FirstWord = X >> 6;
+	const int32 LastWord  = (X1 - 1) >> 6;
+
+	for (int32 RowY = Y; RowY < Y + H; ++RowY)
+	{
+		const uint64* Row = RowPtr(RowY);
+
+		for (int32 WordIdx = FirstWord; WordIdx <= LastWord; ++WordIdx)
+		{
+			const int32 Base = WordIdx << 6;
+			const uint64 Mask = SpanMask(FMath::Max(X, Base) - Base, FMath::Min(X1, Base + 64) - Base);
+
+			if (Row[WordIdx] & Mask)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool FInventoryOccupancyGrid::IsRectFreeIgnoring(int32 X, int32 Y, int32 W, int32 H, const FIntRect& Ignore) const
+{
+	if (!IsRectInBounds(X, Y, W, H))
+	{
+		return false;
+	}
+
+	const int32 X1 = X + W;
+	const int32 FirstWord = X >> 6;
+	const int32 LastWord  = (X1 - 1) >> 6;
+
+	// Колонки Ignore в пределах проверяемого прямоугольника
+	const int32 IgnoreX0 = FMath::Max(X, Ignore.Min.X);
+	const int32 IgnoreX1 = FMath::Min(X1, Ignore.Max.X);
+
+	for (int32 RowY = Y; RowY < Y + H; ++RowY)
+	{
+		const uint64* Row = RowPtr(RowY);
+		const bool bIgnoreRow = (IgnoreX0 < IgnoreX1) && RowY >= Ignore.Min.Y && RowY < Ignore.Max.Y;
+
+		for (int32 WordIdx = FirstWord; WordIdx <= LastWord; ++WordIdx)
+		{
+			const int32 Base = WordIdx << 6;
+			uint64 Mask = SpanMask(FMath::Max(X, Base) - Base, FMath::Min(X1, Base + 64) - Base);
+
+			if (bIgnoreRow)
+			{
+				const int32 From = FMath::Max(IgnoreX0, Base) - Base;
+				const int32 To   = FMath::Min(IgnoreX1, Base + 64) - Base;
+				if (From < To)
+				{
+					Mask &= ~SpanMask(From, To);
+				}
+			}
+
+			if (Row[WordIdx] & Mask)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void FInventoryOccupancyGrid::MergeRows(int32 Y, int32 H, uint64* OutWords) const
+{
+	FMemory::Memzero(OutWords, WordsPerRow * sizeof(uint64));
+
+	for (int32 RowY = Y; RowY < Y + H && RowY < Rows; ++RowY)
+	{
+		const uint64* Row = RowPtr(RowY);
+		for (int32 WordIdx = 0; WordIdx < WordsPerRow; ++WordIdx)
+		{
+			OutWords[WordIdx] |= Row[WordIdx];
+		}
+	}
+}
+
+int32 FInventoryOccupancyGrid::FindNextBit(const uint64* RowWords, int32 FromX, bool bOccupied) const
+{
+	if (FromX >= Columns)
+	{
+		return Columns;
+	}
+
+	FromX = FMath::Max(0, FromX);
+
+	for (int32 WordIdx = FromX >> 6; WordIdx < WordsPerRow; ++WordIdx)
+	{
+		uint64 Word = bOccupied ? RowWords[WordIdx] : ~RowWords[WordIdx];
+
+		// Отбрасываем биты левее FromX в первом слове
+		if (WordIdx == (FromX >> 6))
+		{
+			Word &= ~((1ull << (FromX & 63)) - 1ull);
+		}
+
+		if (Word != 0)
+		{
+			const int32 Pos = (WordIdx << 6) + static_cast<int32>(FMath::CountTrailingZeros64(Word));
+			return FMath::Min(Pos, Columns);
+		}
+	}
+
+	return Columns;
+}
+
+int32 FInventoryOccupancyGrid::FindNextFree(const uint64* RowWords, int32 FromX) const
+{
+	return FindNextBit(RowWords, FromX, false);
+}
+
+int32 FInventoryOccupancyGrid::FindNextOccupied(const uint64* RowWords, int32 FromX) const
+{
+	return FindNextBit(RowWords, FromX, true);
+}
+
+bool FInventoryOccupancyGrid::FindFirstFree(int32 W, int32 H, int32& OutX, int32& OutY) const
+{
+	OutX = INDEX_NONE;
+	OutY = INDEX_NONE;
+
+	if (W <= 0 || H <= 0 || W > Columns || H > Rows)
+	{
+		return false;
+	}
+
+	TArray<uint64, TInlineAllocator<4>> Merged;
+	Merged.SetNumUninitialized(WordsPerRow);
+
+	const int32 MaxX = Columns - W;
+
+	for (int32 Y = 0; Y + H <= Rows; ++Y)
+	{
+		// Клетка свободна для предмета высотой H, только если свободна во всех H строках
+		MergeRows(Y, H, Merged.GetData());
+
+		int32 X = 0;
+		while (X <= MaxX)
+		{
+			const int32 RunStart = FindNextFree(Merged.GetData(), X);
+			if (RunStart > MaxX)
+			{
+				break;
+			}
+
+			const int32 RunEnd = FindNextOccupied(Merged.GetData(), RunStart);
+			if (RunEnd - RunStart >= W)
+			{
+				OutX = RunStart;
+				OutY = Y;
+				return true;
+			}
+
+			// Следующий участок начинается не раньше занятого бита
+			X = RunEnd + 1;
+		}
+	}
+
+	return false;
+}
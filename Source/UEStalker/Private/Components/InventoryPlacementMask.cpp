@@ -0,0 +1,111 @@
+#include "Components/InventoryPlacementMask.h"
+#include "Components/InventoryOccupancyGrid.h"
+
+void FInventoryPlacementMask::Build(const FInventoryOccupancyGrid& Grid, int32 InWidth, int32 InHeight, const FIntRect* Ignore)
+{
+	Reset();
+
+	Columns = Grid.GetColumns();
+	Rows = Grid.GetRows();
+	Width = FMath::Max(1, InWidth);
+	Height = FMath::Max(1, InHeight);
+
+	if (Columns <= 0 || Rows <= 0)
+	{
+		return;
+	}
+
+	Valid.Init(false, Columns * Rows);
+
+	if (Width > Columns || Height > Rows)
+	{
+		return;
+	}
+
+	// Sum[(Y + 1) * Stride + (X + 1)] — занятых клеток в [0, X] x [0, Y]
+	const int32 Stride = Columns + 1;
+	TArray<int32, TInlineAllocator<256>> Sum;
+	Sum.SetNumZeroed(Stride * (Rows + 1));
+
+	for (int32 Y = 0; Y < Rows; ++Y)
+	{
+		int32 RowSum = 0;
+		for (int32 X = 0; X < Columns; ++X)
+		{
+			const bool bIgnored = Ignore && Ignore->Contains(FIntPoint(X, Y));
+			RowSum += (!bIgnored && Grid.IsOccupied(X, Y)) ? 1 : 0;
+			Sum[(Y + 1) * Stride + (X + 1)] = Sum[Y * Stride + (X + 1)] + RowSum;
+		}
+	}
+
+	for (int32 Y = 0; Y + Height <= Rows; ++Y)
+	{
+		for (int32 X = 0; X + Width <= Columns; ++X)
+		{
+			const int32 Occupied =
+				Sum[(Y + Height) * Stride + (X + Width)]
+				- Sum[Y * Stride + (X + Width)]
+				- Sum[(Y + Height) * Stride + X]
+				+ Sum[Y * Stride + X];
+
+			if (Occupied == 0)
+			{
+				Valid[X + (Y * Columns)] = true;
+				++ValidCount;
+			}
+		}
+	}
+}
+
+void FInventoryPlacementMask::Reset()
+{
+	Columns = 0;
+	Rows = 0;
+	Width = 0;
+	Height = 0;
+	ValidCount = 0;
+	Valid.Reset();
+}
+
+bool FInventoryPlacementMask::FindNearestValid(int32 X, int32 Y, int32 MaxDistance, int32& OutX, int32& OutY) const
+{
+	if (ValidCount == 0)
+	{
+		return false;
+	}
+
+	if (IsValid(X, Y))
+	{
+		OutX = X;
+		OutY = Y;
+		return true;
+	}
+
+	// Кольца вокруг (X, Y); в кольце берем ближайшую по евклиду (иначе углы выигрывали бы у соседей)
+	for (int32 Ring = 1; Ring <= MaxDistance; ++Ring)
+	{
+		int32 BestDistSq = MAX_int32;
+
+		for (int32 DY = -Ring; DY <= Ring; ++DY)
+		{
+			const bool bEdgeRow = (DY == -Ring || DY == Ring);
+			for (int32 DX = -Ring; DX <= Ring; DX += (bEdgeRow ? 1 : Ring * 2))
+			{
+				const int32 DistSq = DX * DX + DY * DY;
+				if (DistSq < BestDistSq && IsValid(X + DX, Y + DY))
+				{
+					BestDistSq = DistSq;
+					OutX = X + DX;
+					OutY = Y + DY;
+				}
+			}
+		}
+
+		if (BestDistSq != MAX_int32)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
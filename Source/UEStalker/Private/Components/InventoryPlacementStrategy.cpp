@@ -0,0 +1,303 @@
+#include "Components/InventoryPlacementStrategy.h"
+#include "Components/InventoryOccupancyGrid.h"
+#include "HAL/IConsoleManager.h"
+
+namespace InventoryPlacement
+{
+	/** Оценка кандидата: меньше — лучше (сравнение по полям по порядку). */
+	struct FScore
+	{
+		int32 Primary = MAX_int32;
+		int32 Secondary = MAX_int32;
+		int32 Y = MAX_int32;
+		int32 X = MAX_int32;
+
+		bool operator<(const FScore& Other) const
+		{
+			if (Primary != Other.Primary) return Primary < Other.Primary;
+			if (Secondary != Other.Secondary) return Secondary < Other.Secondary;
+			if (Y != Other.Y) return Y < Other.Y;
+			return X < Other.X;
+		}
+	};
+
+	static bool FindBottomLeft(const FInventoryOccupancyGrid& Grid, int32 W, int32 H, FScore& OutScore)
+	{
+		int32 X = INDEX_NONE;
+		int32 Y = INDEX_NONE;
+		if (!Grid.FindFirstFree(W, H, X, Y))
+		{
+			return false;
+		}
+
+		// Для фиксированной высоты первое row-major место и есть минимальный нижний край
+		OutScore = { Y + H, 0, Y, X };
+		return true;
+	}
+
+	static bool FindBestShortSideFit(const FInventoryOccupancyGrid& Grid, int32 W, int32 H, FScore& OutScore)
+	{
+		const int32 Columns = Grid.GetColumns();
+		const int32 Rows = Grid.GetRows();
+		if (W <= 0 || H <= 0 || W > Columns || H > Rows)
+		{
+			return false;
+		}
+
+		TArray<uint64, TInlineAllocator<4>> Merged;
+		Merged.SetNumUninitialized(Grid.GetWordsPerRow());
+
+		bool bFound = false;
+
+		for (int32 Y = 0; Y + H <= Rows; ++Y)
+		{
+			Grid.MergeRows(Y, H, Merged.GetData());
+
+			int32 RunStart = Grid.FindNextFree(Merged.GetData(), 0);
+			while (RunStart + W <= Columns)
+			{
+				const int32 RunEnd = Grid.FindNextOccupied(Merged.GetData(), RunStart);
+				if (RunEnd - RunStart >= W)
+				{
+					// Прижимаем к левому краю участка; остаток по горизонтали — хвост участка,
+					// по вертикали — сколько свободных строк остается под предметом
+					const int32 LeftoverH = (RunEnd - RunStart) - W;
+
+					int32 LeftoverV = 0;
+					while (Y + H + LeftoverV < Rows && Grid.IsRectFree(RunStart, Y + H + LeftoverV, W, 1))
+					{
+						++LeftoverV;
+					}
+
+					const FScore Score = { FMath::Min(LeftoverH, LeftoverV), FMath::Max(LeftoverH, LeftoverV), Y, RunStart };
+					if (!bFound || Score < OutScore)
+					{
+						OutScore = Score;
+						bFound = true;
+					}
+				}
+
+				RunStart = Grid.FindNextFree(Merged.GetData(), RunEnd);
+			}
+		}
+
+		return bFound;
+	}
+
+	static bool FindSkyline(const FInventoryOccupancyGrid& Grid, int32 W, int32 H, FScore& OutScore)
+	{
+		const int32 Columns = Grid.GetColumns();
+		const int32 Rows = Grid.GetRows();
+		if (W <= 0 || H <= 0 || W > Columns || H > Rows)
+		{
+			return false;
+		}
+
+		// Горизонт колонки: строка под самым нижним занятым битом (все клетки от нее вниз свободны)
+		TArray<int32, TInlineAllocator<64>> Skyline;
+		Skyline.SetNumZeroed(Columns);
+
+		TArray<uint64, TInlineAllocator<4>> Row;
+		Row.SetNumUninitialized(Grid.GetWordsPerRow());
+
+		for (int32 Y = 0; Y < Rows; ++Y)
+		{
+			Grid.MergeRows(Y, 1, Row.GetData());
+
+			for (int32 WordIdx = 0; WordIdx < Row.Num(); ++WordIdx)
+			{
+				uint64 Word = Row[WordIdx];
+				while (Word != 0)
+				{
+					const int32 Bit = static_cast<int32>(FMath::CountTrailingZeros64(Word));
+					Word &= Word - 1ull;
+
+					const int32 X = (WordIdx << 6) + Bit;
+					if (X < Columns)
+					{
+						Skyline[X] = Y + 1;
+					}
+				}
+			}
+		}
+
+		bool bFound = false;
+
+		for (int32 X = 0; X + W <= Columns; ++X)
+		{
+			int32 Y = 0;
+			for (int32 i = X; i < X + W; ++i)
+			{
+				Y = FMath::Max(Y, Skyline[i]);
+			}
+
+			if (Y + H > Rows)
+			{
+				continue;
+			}
+
+			// Клетки между горизонтом и низом предмета — потерянное место
+			int32 Waste = 0;
+			for (int32 i = X; i < X + W; ++i)
+			{
+				Waste += Y - Skyline[i];
+			}
+
+			const FScore Score = { Y + H, Waste, Y, X };
+			if (!bFound || Score < OutScore)
+			{
+				OutScore = Score;
+				bFound = true;
+			}
+		}
+
+		// Горизонт не видит дыр под предметами — если сверху некуда, пробуем в дыры
+		return bFound || FindBottomLeft(Grid, W, H, OutScore);
+	}
+
+	static bool FindForStrategy(const FInventoryOccupancyGrid& Grid, EInventoryPlacementStrategy Strategy, int32 W, int32 H, FScore& OutScore)
+	{
+		switch (Strategy)
+		{
+		case EInventoryPlacementStrategy::BestShortSideFit:
+			return FindBestShortSideFit(Grid, W, H, OutScore);
+
+		case EInventoryPlacementStrategy::Skyline:
+			return FindSkyline(Grid, W, H, OutScore);
+
+		case EInventoryPlacementStrategy::FirstFit:
+		case EInventoryPlacementStrategy::BottomLeft:
+		default:
+			return FindBottomLeft(Grid, W, H, OutScore);
+		}
+	}
+}
+
+bool FInventoryPlacementSolver::FindPlacement(const FInventoryOccupancyGrid& Grid, EInventoryPlacementStrategy Strategy,
+	FIntPoint Size, bool bCanRotate, FIntPoint& OutTopLeft, bool& bOutRotated)
+{
+	using namespace InventoryPlacement;
+
+	OutTopLeft = FIntPoint(INDEX_NONE, INDEX_NONE);
+	bOutRotated = false;
+
+	const int32 W = FMath::Max(1, Size.X);
+	const int32 H = FMath::Max(1, Size.Y);
+	const bool bTryRotated = bCanRotate && W != H;
+
+	FScore Best;
+	const bool bFoundUpright = FindForStrategy(Grid, Strategy, W, H, Best);
+
+	// First Fit сохраняет текущую ориентацию, если она влезает
+	if (bTryRotated && !(bFoundUpright && Strategy == EInventoryPlacementStrategy::FirstFit))
+	{
+		FScore Rotated;
+		if (FindForStrategy(Grid, Strategy, H, W, Rotated) && (!bFoundUpright || Rotated < Best))
+		{
+			Best = Rotated;
+			bOutRotated = true;
+		}
+	}
+
+	if (!bFoundUpright && !bOutRotated)
+	{
+		return false;
+	}
+
+	OutTopLeft = FIntPoint(Best.X, Best.Y);
+	return true;
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace InventoryPlacement
+{
+	/**
+	 * Inventory.BenchmarkPlacement [Sets=200] [Columns=8] [Rows=11] [Seed=1]
+	 * Случайные наборы лута, каждая стратегия кладет предметы по очереди в пустой грид.
+	 * Пишет время на предмет, заполненность и сколько предметов не влезло.
+	 */
+	static void RunBenchmark(const TArray<FString>& Args)
+	{
+		const int32 Sets    = Args.IsValidIndex(0) ? FMath::Max(1, FCString::Atoi(*Args[0])) : 200;
+		const int32 Columns = Args.IsValidIndex(1) ? FMath::Max(1, FCString::Atoi(*Args[1])) : 8;
+		const int32 Rows    = Args.IsValidIndex(2) ? FMath::Max(1, FCString::Atoi(*Args[2])) : 11;
+		const int32 Seed    = Args.IsValidIndex(3) ? FCString::Atoi(*Args[3]) : 1;
+
+		// Типичные размеры: патроны/медицина, гранаты, пистолеты, броня, винтовки
+		static const FIntPoint LootSizes[] =
+		{
+			{1, 1}, {1, 1}, {1, 1}, {1, 2}, {2, 1}, {2, 2}, {1, 3}, {2, 3}, {3, 2}, {2, 4}, {1, 4}, {5, 2},
+		};
+
+		// Наборы общие для всех стратегий
+		FRandomStream Random(Seed);
+		TArray<TArray<TPair<FIntPoint, bool>>> LootSets;
+		LootSets.SetNum(Sets);
+		for (TArray<TPair<FIntPoint, bool>>& Loot : LootSets)
+		{
+			const int32 Count = Random.RandRange(Columns * Rows / 6, Columns * Rows / 2);
+			for (int32 i = 0; i < Count; ++i)
+			{
+				const FIntPoint Size = LootSizes[Random.RandRange(0, static_cast<int32>(UE_ARRAY_COUNT(LootSizes)) - 1)];
+				Loot.Emplace(Size, Random.FRand() < 0.8f);
+			}
+		}
+
+		const UEnum* StrategyEnum = StaticEnum<EInventoryPlacementStrategy>();
+		const int32 NumStrategies = StrategyEnum->NumEnums() - 1; // без _MAX
+
+		for (int32 StrategyIdx = 0; StrategyIdx < NumStrategies; ++StrategyIdx)
+		{
+			const EInventoryPlacementStrategy Strategy = static_cast<EInventoryPlacementStrategy>(StrategyEnum->GetValueByIndex(StrategyIdx));
+
+			FInventoryOccupancyGrid Grid;
+			Grid.Init(Columns, Rows);
+
+			int64 Placed = 0;
+			int64 Rejected = 0;
+			int64 FilledCells = 0;
+			double Seconds = 0.0;
+
+			for (const TArray<TPair<FIntPoint, bool>>& Loot : LootSets)
+			{
+				Grid.Reset();
+
+				for (const TPair<FIntPoint, bool>& Item : Loot)
+				{
+					FIntPoint TopLeft;
+					bool bRotated = false;
+
+					const double Start = FPlatformTime::Seconds();
+					const bool bFound = FindPlacement(Grid, Strategy, Item.Key, Item.Value, TopLeft, bRotated);
+					Seconds += FPlatformTime::Seconds() - Start;
+
+					if (!bFound)
+					{
+						++Rejected;
+						continue;
+					}
+
+					const FIntPoint Size = bRotated ? FIntPoint(Item.Key.Y, Item.Key.X) : Item.Key;
+					Grid.SetRect(TopLeft.X, TopLeft.Y, Size.X, Size.Y, true);
+					FilledCells += Size.X * Size.Y;
+					++Placed;
+				}
+			}
+
+			const double Attempts = FMath::Max<double>(1.0, Placed + Rejected);
+			UE_LOG(LogTemp, Display, TEXT("[InventoryPlacement] %-20s %7.3f us/item  fill %5.1f%%  rejected %lld/%lld"),
+				*StrategyEnum->GetDisplayNameTextByIndex(StrategyIdx).ToString(),
+				Seconds * 1e6 / Attempts,
+				100.0 * static_cast<double>(FilledCells) / (static_cast<double>(Columns) * Rows * Sets),
+				Rejected, Placed + Rejected);
+		}
+	}
+
+	static FAutoConsoleCommand BenchmarkPlacementCommand(
+		TEXT("Inventory.BenchmarkPlacement"),
+		TEXT("Inventory.BenchmarkPlacement [Sets=200] [Columns=8] [Rows=11] [Seed=1] - compare placement strategies on random loot"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmark));
+}
+
+#endif // !UE_BUILD_SHIPPING
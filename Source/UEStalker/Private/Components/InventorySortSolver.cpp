@@ -0,0 +1,215 @@
+#include "Components/InventorySortSolver.h"
+#include "Components/InventoryOccupancyGrid.h"
+
+namespace InventorySort
+{
+	/** Слить неполные стаки одной группы: первые получают MaxStack, последний — остаток, лишние 0. */
+	static void ConsolidateStacks(const FInventorySortRequest& Request, TArray<int32>& OutCounts)
+	{
+		OutCounts.SetNumUninitialized(Request.Items.Num());
+
+		TMap<int32, TArray<int32, TInlineAllocator<8>>> Groups;
+		for (int32 i = 0; i < Request.Items.Num(); ++i)
+		{
+			const FInventorySortItem& Item = Request.Items[i];
+			OutCounts[i] = FMath::Max(1, Item.StackCount);
+
+			if (Item.StackGroup != INDEX_NONE && Item.MaxStack > 1)
+			{
+				Groups.FindOrAdd(Item.StackGroup).Add(i);
+			}
+		}
+
+		for (const TPair<int32, TArray<int32, TInlineAllocator<8>>>& Pair : Groups)
+		{
+			int32 Total = 0;
+			for (const int32 Idx : Pair.Value)
+			{
+				Total += OutCounts[Idx];
+			}
+
+			for (const int32 Idx : Pair.Value)
+			{
+				const int32 Take = FMath::Min(Total, FMath::Max(1, Request.Items[Idx].MaxStack));
+				OutCounts[Idx] = Take;
+				Total -= Take;
+			}
+		}
+	}
+
+	/**
+	 * Один проход укладки в заданном порядке.
+	 * Для каждого предмета — самая верхняя-левая позиция из обеих ориентаций;
+	 * при равенстве решает bPreferRotated.
+	 */
+	static bool PackOnce(const FInventorySortRequest& Request, const TArray<int32>& Order, const TArray<bool>& PreferRotated,
+		FInventoryOccupancyGrid& Grid, TArray<FInventorySortPlacement>& OutPlacements, int32& OutWasted)
+	{
+		Grid.Reset();
+
+		int32 UsedCells = 0;
+		int32 UsedRows = 0;
+
+		for (int32 OrderIdx = 0; OrderIdx < Order.Num(); ++OrderIdx)
+		{
+			const int32 ItemIdx = Order[OrderIdx];
+			const FInventorySortItem& Item = Request.Items[ItemIdx];
+
+			const FIntPoint Upright(FMath::Max(1, Item.Size.X), FMath::Max(1, Item.Size.Y));
+			const bool bTryRotated = Item.bCanRotate && Upright.X != Upright.Y;
+
+			int32 BestX = INDEX_NONE;
+			int32 BestY = INDEX_NONE;
+			bool bBestRotated = false;
+
+			for (int32 Pass = 0; Pass < (bTryRotated ? 2 : 1); ++Pass)
+			{
+				// Первой пробуем предпочтительную ориентацию
+				const bool bRotated = bTryRotated ? ((Pass == 0) == PreferRotated[OrderIdx]) : false;
+				const FIntPoint Size = bRotated ? FIntPoint(Upright.Y, Upright.X) : Upright;
+
+				int32 X = INDEX_NONE;
+				int32 Y = INDEX_NONE;
+				if (!Grid.FindFirstFree(Size.X, Size.Y, X, Y))
+				{
+					continue;
+				}
+
+				if (BestY == INDEX_NONE || Y < BestY || (Y == BestY && X < BestX))
+				{
+					BestX = X;
+					BestY = Y;
+					bBestRotated = bRotated;
+				}
+			}
+
+			if (BestY == INDEX_NONE)
+			{
+				return false;
+			}
+
+			const FIntPoint Size = bBestRotated ? FIntPoint(Upright.Y, Upright.X) : Upright;
+			Grid.SetRect(BestX, BestY, Size.X, Size.Y, true);
+
+			FInventorySortPlacement& Placement = OutPlacements[ItemIdx];
+			Placement.X = BestX;
+			Placement.Y = BestY;
+			Placement.bRotated = bBestRotated;
+
+			UsedCells += Size.X * Size.Y;
+			UsedRows = FMath::Max(UsedRows, BestY + Size.Y);
+		}
+
+		OutWasted = (UsedRows * Request.Columns) - UsedCells;
+		return true;
+	}
+}
+
+FInventorySortResult FInventorySortSolver::Solve(const FInventorySortRequest& Request)
+{
+	FInventorySortResult Result;
+
+	if (Request.Columns <= 0 || Request.Rows <= 0)
+	{
+		return Result;
+	}
+
+	InventorySort::ConsolidateStacks(Request, Result.StackCounts);
+
+	// Базовый порядок: категория -> подкатегория -> крупные вперед -> одинаковые рядом
+	TArray<int32> BaseOrder;
+	BaseOrder.Reserve(Request.Items.Num());
+	for (int32 i = 0; i < Request.Items.Num(); ++i)
+	{
+		if (Result.StackCounts[i] > 0)
+		{
+			BaseOrder.Add(i);
+		}
+	}
+
+	BaseOrder.StableSort([&Request](const int32 A, const int32 B)
+	{
+		const FInventorySortItem& IA = Request.Items[A];
+		const FInventorySortItem& IB = Request.Items[B];
+
+		if (IA.Category != IB.Category) return IA.Category < IB.Category;
+		if (IA.SubCategory != IB.SubCategory) return IA.SubCategory < IB.SubCategory;
+
+		const int32 AreaA = IA.Size.X * IA.Size.Y;
+		const int32 AreaB = IB.Size.X * IB.Size.Y;
+		if (AreaA != AreaB) return AreaA > AreaB;
+
+		return IA.ItemID < IB.ItemID;
+	});
+
+	FInventoryOccupancyGrid Grid;
+	Grid.Init(Request.Columns, Request.Rows);
+
+	TArray<FInventorySortPlacement> Candidate;
+	Candidate.SetNum(Request.Items.Num());
+
+	TArray<int32> Order = BaseOrder;
+	TArray<bool> PreferRotated;
+	PreferRotated.Init(false, Order.Num());
+
+	auto TryCandidate = [&]()
+	{
+		++Result.Iterations;
+
+		int32 Wasted = 0;
+		if (!InventorySort::PackOnce(Request, Order, PreferRotated, Grid, Candidate, Wasted))
+		{
+			return;
+		}
+
+		if (!Result.bSuccess || Wasted < Result.WastedCells)
+		{
+			Result.bSuccess = true;
+			Result.WastedCells = Wasted;
+			Result.Placements = Candidate;
+		}
+	};
+
+	// Базовые варианты: стоя / лежа / "длинной стороной вдоль строки"
+	TryCandidate();
+
+	PreferRotated.Init(true, Order.Num());
+	TryCandidate();
+
+	for (int32 i = 0; i < Order.Num(); ++i)
+	{
+		const FIntPoint Size = Request.Items[Order[i]].Size;
+		PreferRotated[i] = Size.Y > Size.X;
+	}
+	TryCandidate();
+
+	// Дальше — случайные перестановки внутри категории, пока есть бюджет
+	FRandomStream Random(static_cast<int32>(Request.RandomSeed));
+	const double Deadline = FPlatformTime::Seconds() + FMath::Max(0.0, Request.TimeBudgetSeconds);
+
+	while ((!Result.bSuccess || Result.WastedCells > 0) && Order.Num() > 1 && FPlatformTime::Seconds() < Deadline)
+	{
+		Order = BaseOrder;
+
+		for (int32 i = 0; i + 1 < Order.Num(); ++i)
+		{
+			const FInventorySortItem& A = Request.Items[Order[i]];
+			const FInventorySortItem& B = Request.Items[Order[i + 1]];
+
+			// Порядок категорий не трогаем — сортировка должна оставаться сортировкой
+			if (A.Category == B.Category && Random.FRand() < 0.35f)
+			{
+				Order.Swap(i, i + 1);
+			}
+		}
+
+		for (int32 i = 0; i < PreferRotated.Num(); ++i)
+		{
+			PreferRotated[i] = Random.FRand() < 0.5f;
+		}
+
+		TryCandidate();
+	}
+
+	return Result;
+}
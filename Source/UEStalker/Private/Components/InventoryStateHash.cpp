@@ -0,0 +1,64 @@
+#include "Components/InventoryStateHash.h"
+#include "Items/ItemObject.h"
+#include "Items/ItemInstance.h"
+#include "Items/MasterItemDataAsset.h"
+
+namespace InventoryStateHash
+{
+	static FORCEINLINE uint64 FloatBits(float Value)
+	{
+		uint32 Bits = 0;
+		FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+		return Bits;
+	}
+
+	// Поля перечислены в одном порядке для UItemObject и FItemInstance — вклады должны совпадать
+	static uint64 HashState(const UMasterItemDataAsset* Asset, const FItemRuntimeState& Runtime, int32 MagAmmo, EAmmoType MagType, float MagUnitWeight)
+	{
+		uint64 Hash = FInventoryStateHash::Mix(FInventoryStateHash::HashAsset(Asset));
+		Hash = FInventoryStateHash::Combine(Hash, static_cast<uint32>(FMath::Max(1, Runtime.StackCount)));
+		Hash = FInventoryStateHash::Combine(Hash, FloatBits(Runtime.CurrDurability) | (FloatBits(Runtime.CurrCharge) << 32));
+		Hash = FInventoryStateHash::Combine(Hash, Runtime.bIsRotated ? 1ull : 0ull);
+		Hash = FInventoryStateHash::Combine(Hash, static_cast<uint32>(MagAmmo) | (static_cast<uint64>(MagType) << 32));
+		return FInventoryStateHash::Combine(Hash, FloatBits(MagUnitWeight));
+	}
+}
+
+uint64 FInventoryStateHash::HashAsset(const UMasterItemDataAsset* Asset)
+{
+	return Asset ? Asset->GetStableHash() : 0;
+}
+
+uint64 FInventoryStateHash::HashItem(const UItemObject* Item)
+{
+	if (!Item)
+	{
+		return 0;
+	}
+
+	uint64 Hash = InventoryStateHash::HashState(Item->SourceAsset, Item->Runtime,
+		Item->GetMagazineCurrentAmmo(), Item->GetMagazineLoadedAmmoType(), Item->GetMagazineAmmoUnitWeight());
+
+	if (const UItemObject* Mag = Item->GetInsertedMagazine())
+	{
+		Hash = Combine(Hash, InventoryStateHash::HashState(Mag->SourceAsset, Mag->Runtime,
+			Mag->GetMagazineCurrentAmmo(), Mag->GetMagazineLoadedAmmoType(), Mag->GetMagazineAmmoUnitWeight()));
+	}
+
+	return Hash;
+}
+
+uint64 FInventoryStateHash::HashInstance(const FItemInstance& Instance)
+{
+	uint64 Hash = InventoryStateHash::HashState(Instance.SourceAsset, Instance.Runtime,
+		FMath::Max(0, Instance.MagazineCurrentAmmo), Instance.MagazineLoadedAmmoType, Instance.MagazineAmmoUnitWeight);
+
+	if (Instance.bHasInsertedMagazine && Instance.InsertedMagazine.SourceAsset)
+	{
+		const FItemMagazineInstance& Mag = Instance.InsertedMagazine;
+		Hash = Combine(Hash, InventoryStateHash::HashState(Mag.SourceAsset, Mag.Runtime,
+			FMath::Max(0, Mag.CurrentAmmo), Mag.LoadedAmmoType, Mag.AmmoUnitWeight));
+	}
+
+	return Hash;
+}
@@ -1,37 +1,174 @@
 #include "Items/ItemObject.h"
+#include "Items/ItemObjectPoolSubsystem.h"
 #include "Items/MasterItemDataAsset.h"
+#include "Components/EquipmentComponent.h"
+#include "Components/InventoryComponent.h"
 #include "Sound/SoundBase.h"
 
+namespace ItemConfigDefaults
+{
+	// Предмет без ассета читает пустые конфиги
+	static const UMasterItemDataAsset* GetEmptyAsset()
+	{
+		return GetDefault<UMasterItemDataAsset>();
+	}
+}
+
+template <typename TConfig>
+const TConfig& UItemObject::ResolveConfig(EItemConfigOverride Flag, TConfig UMasterItemDataAsset::* AssetMember,
+	TConfig UItemConfigOverrides::* OverrideMember) const
+{
+	if (ConfigOverrides && EnumHasAnyFlags(ConfigOverrides->OverrideMask, Flag))
+	{
+		return ConfigOverrides.Get()->*OverrideMember;
+	}
+
+	const UMasterItemDataAsset* Asset = SourceAsset ? SourceAsset.Get() : ItemConfigDefaults::GetEmptyAsset();
+	return Asset->*AssetMember;
+}
+
+template <typename TConfig>
+TConfig& UItemObject::EditConfig(EItemConfigOverride Flag, TConfig UMasterItemDataAsset::* AssetMember,
+	TConfig UItemConfigOverrides::* OverrideMember)
+{
+	if (!ConfigOverrides)
+	{
+		ConfigOverrides = NewObject<UItemConfigOverrides>(this);
+	}
+
+	// Copy-on-write: копируем из ассета только при первой записи этого конфига
+	if (!EnumHasAnyFlags(ConfigOverrides->OverrideMask, Flag))
+	{
+		const UMasterItemDataAsset* Asset = SourceAsset ? SourceAsset.Get() : ItemConfigDefaults::GetEmptyAsset();
+		ConfigOverrides.Get()->*OverrideMember = Asset->*AssetMember;
+		ConfigOverrides->OverrideMask |= Flag;
+	}
+
+	return ConfigOverrides.Get()->*OverrideMember;
+}
+
+void UItemObject::PostConfigEdit()
+{
+	// Магазин в оружии несет корень — как в NotifyWeightChanged
+	UItemObject* Root = this;
+	for (int32 Depth = 0; Depth < 4 && IsValid(Root->ParentItem.Get()); ++Depth)
+	{
+		Root = Root->ParentItem.Get();
+	}
+
+	UInventoryComponent* Inventory = Root->OwningInventory.Get();
+	if (!Inventory)
+	{
+		return;
+	}
+
+	Inventory->NotifyItemConfigChanged(Root);
+
+	const AActor* Owner = Inventory->GetOwner();
+	if (UEquipmentComponent* Equipment = Owner ? Owner->FindComponentByClass<UEquipmentComponent>() : nullptr)
+	{
+		Equipment->RefreshItemStats(Root);
+	}
+}
+
+const FMasterItemDetails& UItemObject::GetItemDetails() const
+{
+	return ResolveConfig(EItemConfigOverride::ItemDetails, &UMasterItemDataAsset::ItemDetails, &UItemConfigOverrides::ItemDetails);
+}
+
+const FItemTradeConfig& UItemObject::GetTradeConfig() const
+{
+	return ResolveConfig(EItemConfigOverride::TradeConfig, &UMasterItemDataAsset::TradeConfig, &UItemConfigOverrides::TradeConfig);
+}
+
+const FItemDurabilityConfig& UItemObject::GetDurabilityConfig() const
+{
+	return ResolveConfig(EItemConfigOverride::DurabilityConfig, &UMasterItemDataAsset::DurabilityConfig, &UItemConfigOverrides::DurabilityConfig);
+}
+
+const FItemChargeConfig& UItemObject::GetChargeConfig() const
+{
+	return ResolveConfig(EItemConfigOverride::ChargeConfig, &UMasterItemDataAsset::ChargeConfig, &UItemConfigOverrides::ChargeConfig);
+}
+
+const FItemOutfitStatsConfig& UItemObject::GetOutfitStatsConfig() const
+{
+	return ResolveConfig(EItemConfigOverride::OutfitStatsConfig, &UMasterItemDataAsset::OutfitStatsConfig, &UItemConfigOverrides::OutfitStatsConfig);
+}
+
+const FItemWeaponsStatsConfig& UItemObject::GetWeaponStatsConfig() const
+{
+	return ResolveConfig(EItemConfigOverride::WeaponStatsConfig, &UMasterItemDataAsset::WeaponStatsConfig, &UItemConfigOverrides::WeaponStatsConfig);
+}
+
+const FItemMagazineConfig& UItemObject::GetMagazineConfig() const
+{
+	return ResolveConfig(EItemConfigOverride::MagazineConfig, &UMasterItemDataAsset::MagazineConfig, &UItemConfigOverrides::MagazineConfig);
+}
+
+const FConsumablesStats& UItemObject::GetConsumablesStats() const
+{
+	return ResolveConfig(EItemConfigOverride::ConsumablesStats, &UMasterItemDataAsset::ConsumablesStats, &UItemConfigOverrides::ConsumablesStats);
+}
+
+FMasterItemDetails& UItemObject::EditItemDetails()
+{
+	return EditConfig(EItemConfigOverride::ItemDetails, &UMasterItemDataAsset::ItemDetails, &UItemConfigOverrides::ItemDetails);
+}
+
+FItemTradeConfig& UItemObject::EditTradeConfig()
+{
+	return EditConfig(EItemConfigOverride::TradeConfig, &UMasterItemDataAsset::TradeConfig, &UItemConfigOverrides::TradeConfig);
+}
+
+FItemDurabilityConfig& UItemObject::EditDurabilityConfig()
+{
+	return EditConfig(EItemConfigOverride::DurabilityConfig, &UMasterItemDataAsset::DurabilityConfig, &UItemConfigOverrides::DurabilityConfig);
+}
+
+FItemChargeConfig& UItemObject::EditChargeConfig()
+{
+	return EditConfig(EItemConfigOverride::ChargeConfig, &UMasterItemDataAsset::ChargeConfig, &UItemConfigOverrides::ChargeConfig);
+}
+
+FItemOutfitStatsConfig& UItemObject::EditOutfitStatsConfig()
+{
+	return EditConfig(EItemConfigOverride::OutfitStatsConfig, &UMasterItemDataAsset::OutfitStatsConfig, &UItemConfigOverrides::OutfitStatsConfig);
+}
+
+FItemWeaponsStatsConfig& UItemObject::EditWeaponStatsConfig()
+{
+	return EditConfig(EItemConfigOverride::WeaponStatsConfig, &UMasterItemDataAsset::WeaponStatsConfig, &UItemConfigOverrides::WeaponStatsConfig);
+}
+
+FItemMagazineConfig& UItemObject::EditMagazineConfig()
+{
+	return EditConfig(EItemConfigOverride::MagazineConfig, &UMasterItemDataAsset::MagazineConfig, &UItemConfigOverrides::MagazineConfig);
+}
+
+FConsumablesStats& UItemObject::EditConsumablesStats()
+{
+	return EditConfig(EItemConfigOverride::ConsumablesStats, &UMasterItemDataAsset::ConsumablesStats, &UItemConfigOverrides::ConsumablesStats);
+}
+
 void UItemObject::InitializeFromAsset(UMasterItemDataAsset* InAsset, int32 InStackCount)
 {
 	SourceAsset = InAsset;
 
 	if (!SourceAsset)
 	{
-		ItemDetails = FMasterItemDetails{};
-		TradeConfig = FItemTradeConfig{};
-		DurabilityConfig = FItemDurabilityConfig{};
-		ChargeConfig = FItemChargeConfig{};
-		OutfitStatsConfig = FItemOutfitStatsConfig{};
-		WeaponStatsConfig = FItemWeaponsStatsConfig{};
-		MagazineConfig = FItemMagazineConfig{};
-		ConsumablesStats = FConsumablesStats{};
+		ConfigOverrides = nullptr;
 		Runtime = FItemRuntimeState{};
 		InsertedMagazine = nullptr;
 		MagazineCurrentAmmo = 0;
 		MagazineLoadedAmmoType = EAmmoType::AmmoType_None;
 		MagazineAmmoUnitWeight = 0.f;
+		NotifyWeightChanged();
 		return;
 	}
 
-	ItemDetails       = SourceAsset->ItemDetails;
-	TradeConfig       = SourceAsset->TradeConfig;
-	DurabilityConfig  = SourceAsset->DurabilityConfig;
-	ChargeConfig      = SourceAsset->ChargeConfig;
-	OutfitStatsConfig = SourceAsset->OutfitStatsConfig;
-	WeaponStatsConfig = SourceAsset->WeaponStatsConfig;
-	ConsumablesStats  = SourceAsset->ConsumablesStats;
-	MagazineConfig	  = SourceAsset->MagazineConfig;
+	// Конфиги не копируем — Get*() читает их из ассета; старые переопределения к новому ассету не относятся
+	ConfigOverrides = nullptr;
 
 	// Reset runtime attachments
 	InsertedMagazine = nullptr;
@@ -43,33 +180,47 @@ void UItemObject::InitializeFromAsset(UMasterItemDataAsset* InAsset, int32 InSta
 	Runtime.StackCount = 1;
 	SetStackCount(InStackCount);
 
-	Runtime.CurrDurability = DurabilityConfig.bHasDurability ? DurabilityConfig.MaxDurability : 0.f;
-	Runtime.CurrCharge     = ChargeConfig.bHasCharge ? ChargeConfig.MaxCharge : 0.f;
+	Runtime.CurrDurability = GetDurabilityConfig().bHasDurability ? GetDurabilityConfig().MaxDurability : 0.f;
+	Runtime.CurrCharge     = GetChargeConfig().bHasCharge ? GetChargeConfig().MaxCharge : 0.f;
 	Runtime.bIsRotated     = false;
+
+	NotifyWeightChanged();
 }
 
 void UItemObject::SetStackCount(int32 NewCount)
 {
+	const int32 OldCount = Runtime.StackCount;
 	NewCount = FMath::Max(1, NewCount);
 
-	if (!ItemDetails.bIsStackable)
+	if (!GetItemDetails().bIsStackable)
 	{
 		Runtime.StackCount = 1;
-		return;
+	}
+	else
+	{
+		const int32 MaxStack = FMath::Max(1, GetItemDetails().MaxStackCount);
+		Runtime.StackCount = FMath::Clamp(NewCount, 1, MaxStack);
 	}
 
-	const int32 MaxStack = FMath::Max(1, ItemDetails.MaxStackCount);
-	Runtime.StackCount = FMath::Clamp(NewCount, 1, MaxStack);
+	// Инвентарь держит индекс неполных стаков и журнал веса — сообщаем ему
+	if (Runtime.StackCount != OldCount)
+	{
+		if (UInventoryComponent* Inventory = OwningInventory.Get())
+		{
+			Inventory->NotifyItemStackChanged(this);
+		}
+		NotifyWeightChanged();
+	}
 }
 
 USoundBase* UItemObject::GetSoundOfUse() const
 {
-	return ItemDetails.ItemUseSound;
+	return GetItemDetails().ItemUseSound;
 }
 
 void UItemObject::GetDimensions(FItemSize& Dimensions) const
 {
-	Dimensions = ItemDetails.Size;
+	Dimensions = GetItemDetails().Size;
 
 	// Учитываем поворот (как инвентарь раскладывает предмет)
 	if (Runtime.bIsRotated)
@@ -84,22 +235,17 @@ void UItemObject::GetDimensions(FItemSize& Dimensions) const
 
 USoundBase* UItemObject::GetEquipmentSound() const
 {
-	return ItemDetails.ItemEquipSound;
+	return GetItemDetails().ItemEquipSound;
 }
 
 USoundBase* UItemObject::GetDropSound() const
 {
-	return ItemDetails.ItemDropSound;
+	return GetItemDetails().ItemDropSound;
 }
 
 USoundBase* UItemObject::GetPickupSound() const
 {
-	return ItemDetails.ItemPickupSound;
-}
-
-FItemOutfitStatsConfig UItemObject::GetOutfitStats() const
-{
-	return OutfitStatsConfig;
+	return GetItemDetails().ItemPickupSound;
 }
 
 void UItemObject::SetMagazineLoadedAmmoType(EAmmoType NewType)
@@ -117,6 +263,7 @@ void UItemObject::SetMagazineLoadedAmmoType(EAmmoType NewType)
 		{
 			MagazineLoadedAmmoType = EAmmoType::AmmoType_None;
 			MagazineAmmoUnitWeight = 0.f;
+			NotifyWeightChanged();
 		}
 		return;
 	}
@@ -137,31 +284,103 @@ bool UItemObject::IsAmmoCompatibleForMagazine(EAmmoType AmmoType) const
 		return false;
 	}
 
-	return MagazineConfig.CompatibleAmmoTypes.Contains(AmmoType);
+	return (GetCompatibleAmmoMask() & UMasterItemDataAsset::AmmoTypeBit(AmmoType)) != 0;
 }
 
-bool UItemObject::IsMagazineCompatibleForWeapon(const UItemObject* MagItem) const
+EMagazineType UItemObject::GetMagazineType() const
 {
-	if (!IsWeapon() || !IsValid(MagItem) || !MagItem->IsMagazine())
+	const EMagazineType MagType = GetItemDetails().MagazineType;
+	return MagType != EMagazineType::Mag_None ? MagType : GetMagazineConfig().MagazineType;
+}
+
+uint64 UItemObject::GetCompatibleAmmoMask() const
+{
+	// Своя копия конфига — маску ассета использовать нельзя
+	if (ConfigOverrides && EnumHasAnyFlags(ConfigOverrides->OverrideMask, EItemConfigOverride::MagazineConfig))
 	{
-		return false;
+		return UMasterItemDataAsset::BuildAmmoMask(ConfigOverrides->MagazineConfig.CompatibleAmmoTypes);
+	}
+
+	return SourceAsset ? SourceAsset->GetCompatibleAmmoMask() : 0;
+}
+
+uint64 UItemObject::GetCompatibleMagazineMask() const
+{
+	if (ConfigOverrides && EnumHasAnyFlags(ConfigOverrides->OverrideMask, EItemConfigOverride::WeaponStatsConfig))
+	{
+		return UMasterItemDataAsset::BuildMagazineMask(ConfigOverrides->WeaponStatsConfig.CompatibleMagazines);
+	}
+
+	return SourceAsset ? SourceAsset->GetCompatibleMagazineMask() : 0;
+}
+
+
+
+uint32 UItemObject::GetEquipSlotMask() const
+{
+	if (ConfigOverrides && EnumHasAnyFlags(ConfigOverrides->OverrideMask, EItemConfigOverride::ItemDetails))
+	{
+		const FMasterItemDetails& Details = ConfigOverrides->ItemDetails;
+		return UEquipmentComponent::ComputeStaticSlotMask(Details.ItemCategory, Details.ItemSubCategory);
+	}
+
+	return SourceAsset ? SourceAsset->GetEquipSlotMask() : 0;
+}
+
+
+
+const FItemTagBits& UItemObject::GetItemTagBits(FItemTagBits& Scratch) const
+{
+	if (ConfigOverrides && EnumHasAnyFlags(ConfigOverrides->OverrideMask, EItemConfigOverride::ItemDetails))
+	{
+		Scratch = FItemTagBits::FromTags(ConfigOverrides->ItemDetails.ItemTags);
+		return Scratch;
+	}
+
+	const UMasterItemDataAsset* Asset = SourceAsset ? SourceAsset.Get() : ItemConfigDefaults::GetEmptyAsset();
+	return Asset->GetItemTagBits();
+}
+
+const FCompiledItemFilter& UItemObject::GetHelmetFilter(FCompiledItemFilter& Scratch) const
+{
+	if (ConfigOverrides && EnumHasAnyFlags(ConfigOverrides->OverrideMask, EItemConfigOverride::OutfitStatsConfig))
+	{
+		UMasterItemDataAsset::CompileHelmetFilter(ConfigOverrides->OutfitStatsConfig, Scratch);
+		return Scratch;
+	}
+
+	const UMasterItemDataAsset* Asset = SourceAsset ? SourceAsset.Get() : ItemConfigDefaults::GetEmptyAsset();
+	return Asset->GetHelmetFilter();
+}
+
+const FCompiledItemFilter& UItemObject::GetBackpackFilter(FCompiledItemFilter& Scratch) const
+{
+	if (ConfigOverrides && EnumHasAnyFlags(ConfigOverrides->OverrideMask, EItemConfigOverride::OutfitStatsConfig))
+	{
+		UMasterItemDataAsset::CompileBackpackFilter(ConfigOverrides->OutfitStatsConfig, Scratch);
+		return Scratch;
 	}
 
-	// Determine magazine type
-	EMagazineType MagType = MagItem->ItemDetails.MagazineType;
-	if (MagType == EMagazineType::Mag_None)
+	const UMasterItemDataAsset* Asset = SourceAsset ? SourceAsset.Get() : ItemConfigDefaults::GetEmptyAsset();
+	return Asset->GetBackpackFilter();
+}
+
+bool UItemObject::IsMagazineCompatibleForWeapon(const UItemObject* MagItem) const
+{
+	if (!IsWeapon() || !IsValid(MagItem) || !MagItem->IsMagazine())
 	{
-		MagType = MagItem->MagazineConfig.MagazineType;
+		return false;
 	}
 
 	// Prefer explicit compatibility list
-	if (WeaponStatsConfig.CompatibleMagazines.Num() > 0)
+	const uint64 MagazineMask = GetCompatibleMagazineMask();
+	if (MagazineMask != 0)
 	{
-		return WeaponStatsConfig.CompatibleMagazines.Contains(MagType);
+		return (MagazineMask & UMasterItemDataAsset::MagazineTypeBit(MagItem->GetMagazineType())) != 0;
 	}
 
 	// Fallback: match weapon ammo type to magazine compatible ammo types
-	const EAmmoType WeaponAmmo = WeaponStatsConfig.AmmoType;
+	const EAmmoType WeaponAmmo = GetWeaponStatsConfig().AmmoType;
 	if (WeaponAmmo == EAmmoType::AmmoType_None)
 	{
 		return false;
@@ -169,3 +388,159 @@ bool UItemObject::IsMagazineCompatibleForWeapon(const UItemObject* MagItem) cons
 
 	return MagItem->IsAmmoCompatibleForMagazine(WeaponAmmo);
 }
+
+void UItemObject::SetInsertedMagazine(UItemObject* NewMag)
+{
+	if (InsertedMagazine == NewMag)
+	{
+		return;
+	}
+
+	if (IsValid(InsertedMagazine) && InsertedMagazine->ParentItem.Get() == this)
+	{
+		InsertedMagazine->ParentItem.Reset();
+	}
+
+	InsertedMagazine = NewMag;
+
+	if (IsValid(InsertedMagazine))
+	{
+		InsertedMagazine->ParentItem = this;
+	}
+
+	NotifyWeightChanged();
+}
+
+void UItemObject::SetMagazineCurrentAmmo(int32 NewValue)
+{
+	NewValue = FMath::Max(0, NewValue);
+	if (MagazineCurrentAmmo == NewValue)
+	{
+		return;
+	}
+
+	MagazineCurrentAmmo = NewValue;
+	NotifyWeightChanged();
+}
+
+void UItemObject::SetMagazineAmmoUnitWeight(float NewValue)
+{
+	NewValue = FMath::Max(0.f, NewValue);
+	if (MagazineAmmoUnitWeight == NewValue)
+	{
+		return;
+	}
+
+	MagazineAmmoUnitWeight = NewValue;
+	NotifyWeightChanged();
+}
+
+FItemInstance UItemObject::MakeInstance() const
+{
+	FItemInstance Instance;
+	Instance.SourceAsset = SourceAsset;
+	Instance.Runtime = Runtime;
+	Instance.MagazineCurrentAmmo = MagazineCurrentAmmo;
+	Instance.MagazineLoadedAmmoType = MagazineLoadedAmmoType;
+	Instance.MagazineAmmoUnitWeight = MagazineAmmoUnitWeight;
+
+	if (IsValid(InsertedMagazine))
+	{
+		Instance.bHasInsertedMagazine = true;
+		Instance.InsertedMagazine.SourceAsset = InsertedMagazine->SourceAsset;
+		Instance.InsertedMagazine.Runtime = InsertedMagazine->Runtime;
+		Instance.InsertedMagazine.CurrentAmmo = InsertedMagazine->MagazineCurrentAmmo;
+		Instance.InsertedMagazine.LoadedAmmoType = InsertedMagazine->MagazineLoadedAmmoType;
+		Instance.InsertedMagazine.AmmoUnitWeight = InsertedMagazine->MagazineAmmoUnitWeight;
+	}
+
+	return Instance;
+}
+
+FItemInstance UItemObject::MakeAssetInstance(UMasterItemDataAsset* InAsset, int32 InStackCount)
+{
+	FItemInstance Instance;
+	Instance.SourceAsset = InAsset;
+	if (!InAsset)
+	{
+		return Instance;
+	}
+
+	// Как SetStackCount + InitializeFromAsset, но без UItemObject (переопределений у нового предмета нет)
+	const FMasterItemDetails& Details = InAsset->ItemDetails;
+	Instance.Runtime.StackCount = Details.bIsStackable ? FMath::Clamp(InStackCount, 1, FMath::Max(1, Details.MaxStackCount)) : 1;
+	Instance.Runtime.CurrDurability = InAsset->DurabilityConfig.bHasDurability ? InAsset->DurabilityConfig.MaxDurability : 0.f;
+	Instance.Runtime.CurrCharge     = InAsset->ChargeConfig.bHasCharge ? InAsset->ChargeConfig.MaxCharge : 0.f;
+	Instance.Runtime.bIsRotated     = false;
+	return Instance;
+}
+
+void UItemObject::InitializeFromInstance(const FItemInstance& Instance)
+{
+	InitializeFromAsset(Instance.SourceAsset, Instance.Runtime.StackCount);
+	Runtime = Instance.Runtime;
+	Runtime.StackCount = FMath::Max(1, Instance.Runtime.StackCount);
+
+	// Напрямую, как в RestoreSnapshot: состояние уже валидно
+	MagazineCurrentAmmo = Instance.MagazineCurrentAmmo;
+	MagazineLoadedAmmoType = Instance.MagazineLoadedAmmoType;
+	MagazineAmmoUnitWeight = Instance.MagazineAmmoUnitWeight;
+
+	if (Instance.bHasInsertedMagazine && Instance.InsertedMagazine.SourceAsset)
+	{
+		UItemObject* Mag = UItemObjectPoolSubsystem::AcquireItem(this, Instance.InsertedMagazine.SourceAsset, 1);
+		Mag->Runtime = Instance.InsertedMagazine.Runtime;
+		Mag->MagazineCurrentAmmo = Instance.InsertedMagazine.CurrentAmmo;
+		Mag->MagazineLoadedAmmoType = Instance.InsertedMagazine.LoadedAmmoType;
+		Mag->MagazineAmmoUnitWeight = Instance.InsertedMagazine.AmmoUnitWeight;
+		SetInsertedMagazine(Mag);
+	}
+
+	NotifyWeightChanged();
+}
+
+FItemObjectSnapshot UItemObject::MakeSnapshot() const
+{
+	FItemObjectSnapshot Snapshot;
+	Snapshot.Runtime = Runtime;
+	Snapshot.InsertedMagazine = InsertedMagazine;
+	Snapshot.MagazineCurrentAmmo = MagazineCurrentAmmo;
+	Snapshot.MagazineLoadedAmmoType = MagazineLoadedAmmoType;
+	Snapshot.MagazineAmmoUnitWeight = MagazineAmmoUnitWeight;
+	return Snapshot;
+}
+
+void UItemObject::RestoreSnapshot(const FItemObjectSnapshot& Snapshot)
+{
+	SetStackCount(Snapshot.Runtime.StackCount);
+	Runtime = Snapshot.Runtime;
+
+	SetInsertedMagazine(Snapshot.InsertedMagazine.Get());
+
+	// Напрямую: SetMagazineLoadedAmmoType не дает сменить тип у непустого магазина
+	MagazineCurrentAmmo = Snapshot.MagazineCurrentAmmo;
+	MagazineLoadedAmmoType = Snapshot.MagazineLoadedAmmoType;
+	MagazineAmmoUnitWeight = Snapshot.MagazineAmmoUnitWeight;
+
+	NotifyWeightChanged();
+}
+
+void UItemObject::NotifyWeightChanged()
+{
+	// Вес вложенного магазина учитывается в оружии -> поднимаемся до корня
+	UItemObject* Root = this;
+	for (int32 Depth = 0; Depth < 4; ++Depth)
+	{
+		UItemObject* Parent = Root->ParentItem.Get();
+		if (!IsValid(Parent))
+		{
+			break;
+		}
+		Root = Parent;
+	}
+
+	if (UInventoryComponent* Inventory = Root->OwningInventory.Get())
+	{
+		Inventory->NotifyItemWeightChanged(Root);
+	}
+}
@@ -0,0 +1,166 @@
+#include "Items/ItemObjectPoolSubsystem.h"
+#include "Items/ItemObject.h"
+#include "Items/ItemInstance.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+namespace ItemObjectPool
+{
+	static UItemObjectPoolSubsystem* FindPool(const UObject* WorldContext)
+	{
+		UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+		return World ? World->GetSubsystem<UItemObjectPoolSubsystem>() : nullptr;
+	}
+}
+
+UItemObject* UItemObjectPoolSubsystem::AcquireItem(const UObject* WorldContext, UMasterItemDataAsset* Asset, int32 StackCount)
+{
+	if (UItemObjectPoolSubsystem* Pool = ItemObjectPool::FindPool(WorldContext))
+	{
+		return Pool->Acquire(Asset, StackCount);
+	}
+
+	UItemObject* Item = NewObject<UItemObject>(GetTransientPackage());
+	Item->InitializeFromAsset(Asset, StackCount);
+	return Item;
+}
+
+
+UItemObject* UItemObjectPoolSubsystem::AcquireItem(const UObject* WorldContext, const FItemInstance& Instance)
+{
+	UItemObject* Item = AcquireItem(WorldContext, Instance.SourceAsset, FMath::Max(1, Instance.Runtime.StackCount));
+	Item->InitializeFromInstance(Instance);
+	return Item;
+}
+
+void UItemObjectPoolSubsystem::ReleaseItem(const UObject* WorldContext, UItemObject* Item)
+{
+	if (UItemObjectPoolSubsystem* Pool = ItemObjectPool::FindPool(WorldContext))
+	{
+		Pool->Release(Item);
+	}
+}
+
+UItemObject* UItemObjectPoolSubsystem::Acquire(UMasterItemDataAsset* Asset, int32 StackCount)
+{
+	PromotePending();
+
+	UItemObject* Item = nullptr;
+	while (FreeItems.Num() > 0 && !IsValid(Item))
+	{
+		Item = FreeItems.Pop();
+	}
+
+	if (IsValid(Item))
+	{
+		++Stats.Hits;
+	}
+	else
+	{
+		++Stats.Misses;
+		Item = NewObject<UItemObject>(this);
+	}
+
+	// Старые связи сбрасываем до InitializeFromAsset: он сообщает вес носителю
+	Item->OwningInventory.Reset();
+	Item->ParentItem.Reset();
+	Item->Runtime = FItemRuntimeState{};
+	Item->InitializeFromAsset(Asset, StackCount);
+	return Item;
+}
+
+void UItemObjectPoolSubsystem::Release(UItemObject* Item)
+{
+	if (!IsValid(Item))
+	{
+		return;
+	}
+
+	// Предмет еще лежит в инвентаре / вставлен в оружие — его держат, в пул нельзя.
+	// С переопределенными конфигами — тоже: это уникальный предмет, а Acquire их сбрасывает
+	if (Item->OwningInventory.IsValid() || Item->ParentItem.IsValid() || Item->HasConfigOverrides())
+	{
+		++Stats.Rejected;
+		return;
+	}
+
+	PromotePending();
+
+	if (FreeItems.Num() + PendingItems.Num() >= MaxPooled || PendingItems.Contains(Item) || FreeItems.Contains(Item))
+	{
+		++Stats.Rejected;
+		return;
+	}
+
+	// Магазин уходит вместе с оружием (отцепляем, чтобы он не числился вставленным)
+	if (UItemObject* Mag = Item->GetInsertedMagazine())
+	{
+		Item->SetInsertedMagazine(nullptr);
+		Release(Mag);
+	}
+
+	PendingItems.Add(Item);
+	PendingFrames.Add(GFrameCounter);
+	++Stats.Released;
+}
+
+FItemObjectPoolStats UItemObjectPoolSubsystem::GetStats() const
+{
+	FItemObjectPoolStats Result = Stats;
+	Result.Pooled = FreeItems.Num() + PendingItems.Num();
+	return Result;
+}
+
+void UItemObjectPoolSubsystem::Deinitialize()
+{
+	FreeItems.Reset();
+	PendingItems.Reset();
+	PendingFrames.Reset();
+
+	Super::Deinitialize();
+}
+
+void UItemObjectPoolSubsystem::PromotePending()
+{
+	int32 NumReady = 0;
+	while (NumReady < PendingFrames.Num() && PendingFrames[NumReady] + QuarantineFrames <= GFrameCounter)
+	{
+		++NumReady;
+	}
+
+	if (NumReady == 0)
+	{
+		return;
+	}
+
+	FreeItems.Append(PendingItems.GetData(), NumReady);
+	PendingItems.RemoveAt(0, NumReady);
+	PendingFrames.RemoveAt(0, NumReady);
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace ItemObjectPool
+{
+	static void DumpStats(const TArray<FString>& Args, UWorld* World)
+	{
+		const UItemObjectPoolSubsystem* Pool = World ? World->GetSubsystem<UItemObjectPoolSubsystem>() : nullptr;
+		if (!Pool)
+		{
+			return;
+		}
+
+		const FItemObjectPoolStats S = Pool->GetStats();
+		const int32 Requests = S.Hits + S.Misses;
+		UE_LOG(LogTemp, Display, TEXT("[ItemObjectPool] hits %d  misses %d  (hit rate %.1f%%)  released %d  rejected %d  pooled %d"),
+			S.Hits, S.Misses, Requests > 0 ? 100.0 * S.Hits / Requests : 0.0, S.Released, S.Rejected, S.Pooled);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs PoolStatsCommand(
+		TEXT("Inventory.ItemPoolStats"),
+		TEXT("Inventory.ItemPoolStats - print UItemObject pool hit/miss statistics for the current world"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&DumpStats));
+}
+
+#endif // !UE_BUILD_SHIPPING
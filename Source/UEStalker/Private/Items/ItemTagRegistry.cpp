@@ -0,0 +1,106 @@
+#include "Items/ItemTagRegistry.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/ScopeLock.h"
+
+namespace ItemTagRegistry
+{
+	static FCriticalSection& GetLock()
+	{
+		static FCriticalSection Lock;
+		return Lock;
+	}
+
+	static TMap<FName, int32>& GetBits()
+	{
+		static TMap<FName, int32> Bits;
+		return Bits;
+	}
+}
+
+int32 FItemTagRegistry::Intern(FName Tag)
+{
+	FScopeLock Lock(&ItemTagRegistry::GetLock());
+
+	TMap<FName, int32>& Bits = ItemTagRegistry::GetBits();
+	if (const int32* Found = Bits.Find(Tag))
+	{
+		return *Found;
+	}
+
+	return Bits.Add(Tag, Bits.Num());
+}
+
+int32 FItemTagRegistry::Num()
+{
+	FScopeLock Lock(&ItemTagRegistry::GetLock());
+
+	return ItemTagRegistry::GetBits().Num();
+}
+
+FItemTagBits FItemTagBits::FromTags(const TArray<FName>& Tags)
+{
+	FItemTagBits Result;
+	for (const FName& Tag : Tags)
+	{
+		Result.Add(FItemTagRegistry::Intern(Tag));
+	}
+	return Result;
+}
+
+void FItemTagBits::Add(int32 Bit)
+{
+	if (Bit < 0)
+	{
+		return;
+	}
+
+	const int32 WordIdx = Bit >> 6;
+	if (Words.Num() <= WordIdx)
+	{
+		Words.SetNumZeroed(WordIdx + 1);
+	}
+
+	Words[WordIdx] |= 1ull << (Bit & 63);
+}
+
+void FCompiledItemFilter::Compile(const TArray<int32>& InAllowedIDs, const TArray<int32>& InBlockedIDs,
+	const TArray<FName>& InAllowedTags, const TArray<FName>& InBlockedTags)
+{
+	AllowedIDs = InAllowedIDs;
+	AllowedIDs.Sort();
+
+	BlockedIDs = InBlockedIDs;
+	BlockedIDs.Sort();
+
+	// Тэги списков тоже регистрируем, иначе тэг, которого нет ни у одного предмета, не получил бы бит.
+	// Биты годятся только для сравнения в этом процессе (фильтр пересобирается при загрузке, не сериализуется)
+	AllowedTags = FItemTagBits::FromTags(InAllowedTags);
+	BlockedTags = FItemTagBits::FromTags(InBlockedTags);
+
+	bHasAllowedTags = InAllowedTags.Num() > 0;
+}
+
+bool FCompiledItemFilter::Allows(int32 ItemID, const FItemTagBits& ItemTags) const
+{
+	// hard-block
+	if (BlockedIDs.Num() > 0 && Algo::BinarySearch(BlockedIDs, ItemID) != INDEX_NONE)
+	{
+		return false;
+	}
+	if (BlockedTags.Intersects(ItemTags))
+	{
+		return false;
+	}
+
+	// allow-list (если задана — нужно пройти)
+	if (AllowedIDs.Num() > 0 && Algo::BinarySearch(AllowedIDs, ItemID) == INDEX_NONE)
+	{
+		return false;
+	}
+	if (bHasAllowedTags && !AllowedTags.Intersects(ItemTags))
+	{
+		return false;
+	}
+
+	return true;
+}
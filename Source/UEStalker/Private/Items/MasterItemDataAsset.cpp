@@ -1 +1,73 @@
 #include "Items/MasterItemDataAsset.h"
+#include "Components/EquipmentComponent.h"
+#include "Components/InventoryStateHash.h"
+#include "Hash/CityHash.h"
+
+void UMasterItemDataAsset::PostLoad()
+{
+	Super::PostLoad();
+
+	RebuildCompatibilityMasks();
+}
+
+#if WITH_EDITOR
+void UMasterItemDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	RebuildCompatibilityMasks();
+}
+#endif
+
+uint64 UMasterItemDataAsset::BuildAmmoMask(const TArray<EAmmoType>& Types)
+{
+	uint64 Mask = 0;
+	for (const EAmmoType Type : Types)
+	{
+		// None в списке ничего не разрешает
+		if (Type != EAmmoType::AmmoType_None)
+		{
+			Mask |= AmmoTypeBit(Type);
+		}
+	}
+	return Mask;
+}
+
+uint64 UMasterItemDataAsset::BuildMagazineMask(const TArray<EMagazineType>& Types)
+{
+	uint64 Mask = 0;
+	for (const EMagazineType Type : Types)
+	{
+		Mask |= MagazineTypeBit(Type);
+	}
+	return Mask;
+}
+
+void UMasterItemDataAsset::RebuildCompatibilityMasks() const
+{
+	CompatibleAmmoMask = BuildAmmoMask(MagazineConfig.CompatibleAmmoTypes);
+	CompatibleMagazineMask = BuildMagazineMask(WeaponStatsConfig.CompatibleMagazines);
+	EquipSlotMask = UEquipmentComponent::ComputeStaticSlotMask(ItemDetails.ItemCategory, ItemDetails.ItemSubCategory);
+
+	ItemTagBits = FItemTagBits::FromTags(ItemDetails.ItemTags);
+	CompileHelmetFilter(OutfitStatsConfig, HelmetFilter);
+	CompileBackpackFilter(OutfitStatsConfig, BackpackFilter);
+
+	// UTF-8, чтобы не зависеть от размера TCHAR на платформе
+	const FTCHARToUTF8 AssetId(*GetPrimaryAssetId().ToString());
+	StableHash = FInventoryStateHash::Combine(CityHash64(AssetId.Get(), AssetId.Length()), static_cast<uint32>(ItemDetails.ItemID));
+
+	bCompatibilityMasksBuilt = true;
+}
+
+
+
+void UMasterItemDataAsset::CompileHelmetFilter(const FItemOutfitStatsConfig& Config, FCompiledItemFilter& OutFilter)
+{
+	OutFilter.Compile(Config.AllowedHelmetItemIDs, Config.BlockedHelmetItemIDs, Config.AllowedHelmetTags, Config.BlockedHelmetTags);
+}
+
+void UMasterItemDataAsset::CompileBackpackFilter(const FItemOutfitStatsConfig& Config, FCompiledItemFilter& OutFilter)
+{
+	OutFilter.Compile(Config.AllowedBackpackItemIDs, Config.BlockedBackpackItemIDs, Config.AllowedBackpackTags, Config.BlockedBackpackTags);
+}
@@ -86,10 +86,10 @@ void UDragItemVisualWidget::ApplySetup()
 	RootSizeBox->SetWidthOverride(W);
 	RootSizeBox->SetHeightOverride(H);
 
-	UTexture2D* IconTex = PendingItem->ItemDetails.ItemIcon;
-	if (PendingItem->Runtime.bIsRotated && IsValid(PendingItem->ItemDetails.IconRotated))
+	UTexture2D* IconTex = PendingItem->GetItemDetails().ItemIcon;
+	if (PendingItem->Runtime.bIsRotated && IsValid(PendingItem->GetItemDetails().IconRotated))
 	{
-		IconTex = PendingItem->ItemDetails.IconRotated;
+		IconTex = PendingItem->GetItemDetails().IconRotated;
 	}
 
 	if (IsValid(IconTex))
@@ -41,7 +41,7 @@ bool UDropAreaWidget::NativeOnDrop(const FGeometry& InGeometry, const FDragDropE
 	}
 
 	// Play drop sound
-	if (USoundBase* DropSound = ItemObject->ItemDetails.ItemDropSound)
+	if (USoundBase* DropSound = ItemObject->GetItemDetails().ItemDropSound)
 	{
 		AActor* OwnerActor = InventoryComponent->GetOwner();
 		const FVector Loc = IsValid(OwnerActor) ? OwnerActor->GetActorLocation() : FVector::ZeroVector;
@@ -40,6 +40,12 @@ bool UInventoryGridWidget::IsRoomAvailableForPayload(const FInventoryItemPayload
 		return false;
 	}
 
+	// Во время drag — ответ из маски, без обхода футпринта
+	if (IsDropMaskCurrent(Payload.ItemObject, Operation))
+	{
+		return DropMask.IsValid(DraggedItemTopLeftTileX, DraggedItemTopLeftTileY);
+	}
+
 	const FTile TopLeftTile(DraggedItemTopLeftTileX, DraggedItemTopLeftTileY);
 	const int32 TopLeftIndex = InventoryComponent->TileToIndex(TopLeftTile);
 	if (TopLeftIndex == INDEX_NONE)
@@ -48,15 +54,90 @@ bool UInventoryGridWidget::IsRoomAvailableForPayload(const FInventoryItemPayload
 	}
 
 	// Если перетаскиваем предмет внутри того же инвентаря — разрешаем перекрывать его старые клетки
-	if (const UInventoryItemDragDropOperation* InvOp = Cast<UInventoryItemDragDropOperation>(Operation))
+	if (IsMoveWithinGrid(Operation))
+	{
+		return InventoryComponent->IsRoomAvailableForMove(Payload.ItemObject, TopLeftIndex);
+	}
+
+	return InventoryComponent->IsRoomAvailable(Payload.ItemObject, TopLeftIndex);
+}
+
+bool UInventoryGridWidget::IsMoveWithinGrid(const UDragDropOperation* Operation) const
+{
+	const UInventoryItemDragDropOperation* InvOp = Cast<UInventoryItemDragDropOperation>(Operation);
+	return InvOp && InvOp->SourceInventory == InventoryComponent;
+}
+
+bool UInventoryGridWidget::IsDropMaskCurrent(const UItemObject* Item, const UDragDropOperation* Operation) const
+{
+	if (!DropMask.IsBuilt() || !IsValid(InventoryComponent) || DropMaskItem.Get() != Item)
 	{
-		if (InvOp->SourceInventory == InventoryComponent)
+		return false;
+	}
+
+	FItemSize Dims;
+	Item->GetDimensions(Dims);
+
+	return DropMask.IsBuiltFor(FMath::Max(1, Dims.X), FMath::Max(1, Dims.Y))
+		&& DropMask.GetColumns() == InventoryComponent->Columns
+		&& DropMask.GetRows() == InventoryComponent->Rows
+		&& DropMaskContentHash == InventoryComponent->GetContentHash()
+		&& bDropMaskIgnoresOwnCells == IsMoveWithinGrid(Operation);
+}
+
+bool UInventoryGridWidget::UpdateDropMask(UItemObject* Item, const UDragDropOperation* Operation)
+{
+	if (IsDropMaskCurrent(Item, Operation))
+	{
+		return false;
+	}
+
+	// Один проход по гриду на предмет/ориентацию/изменение содержимого, а не на каждое движение мыши
+	bDropMaskIgnoresOwnCells = IsMoveWithinGrid(Operation);
+	InventoryComponent->BuildPlacementMask(Item, bDropMaskIgnoresOwnCells, DropMask);
+	DropMaskItem = Item;
+	DropMaskContentHash = InventoryComponent->GetContentHash();
+	return true;
+}
+
+
+
+void UInventoryGridWidget::HighlightApplyTargets(const UItemObject* Payload)
+{
+	ClearApplyTargetHighlights();
+
+	if (!IsValid(InventoryComponent) || !IsValid(Payload))
+	{
+		return;
+	}
+
+	// Один запрос на drag вместо CanApplyItemToItem на каждый hover
+	TArray<UItemObject*> Targets;
+	InventoryComponent->GetAppliableTargets(Payload, Targets);
+
+	for (UItemObject* Target : Targets)
+	{
+		// Надетые предметы в гриде не рисуются
+		const TObjectPtr<UInventoryItemWidget>* Found = ItemWidgets.Find(Target);
+		if (Found && IsValid(*Found))
 		{
-			return InventoryComponent->IsRoomAvailableForMove(Payload.ItemObject, TopLeftIndex);
+			(*Found)->SetApplyTargetHighlight(true);
+			ApplyTargetWidgets.Add(Found->Get());
 		}
 	}
+}
 
-	return InventoryComponent->IsRoomAvailable(Payload.ItemObject, TopLeftIndex);
+void UInventoryGridWidget::ClearApplyTargetHighlights()
+{
+	for (const TWeakObjectPtr<UInventoryItemWidget>& Widget : ApplyTargetWidgets)
+	{
+		if (UInventoryItemWidget* ItemWidget = Widget.Get())
+		{
+			ItemWidget->SetApplyTargetHighlight(false);
+		}
+	}
+
+	ApplyTargetWidgets.Reset();
 }
 
 void UInventoryGridWidget::GetMousePositionInTile(FVector2D& LocalPos, bool& bRight, bool& bDown) const
@@ -109,8 +190,8 @@ void UInventoryGridWidget::OnItemUsed(UItemObject* ItemObject)
 	}
 
 	// Only use consumables on double click, avoid deleting weapons/armor by accident
-	const EItemCategory Cat = ItemObject->ItemDetails.ItemCategory;
-	const EItemSubCategory Sub = ItemObject->ItemDetails.ItemSubCategory;
+	const EItemCategory Cat = ItemObject->GetItemDetails().ItemCategory;
+	const EItemSubCategory Sub = ItemObject->GetItemDetails().ItemSubCategory;
 
 	const bool bIsConsumable =
 		(Cat == EItemCategory::ItemCat_UsableItems) ||
@@ -183,14 +264,20 @@ void UInventoryGridWidget::InitializeGrid(UInventoryComponent* InInventoryCompon
 	WBInventory = InWBInventory;
 	TileSize = InTileSize;
 
+	// UI нужны UItemObject — создаем их для предметов, хранимых по значению
+	if (IsValid(InventoryComponent))
+	{
+		InventoryComponent->MaterializeItems();
+	}
+
 	CreateLineSegments();
 	Refresh();
 
 	if (IsValid(InventoryComponent))
 	{
 		// Чтобы не плодить подписки
-		InventoryComponent->OnInventoryChanged.RemoveAll(this);
-		InventoryComponent->OnInventoryChanged.AddDynamic(this, &UInventoryGridWidget::Refresh);
+		InventoryComponent->OnInventoryDeltaNative.RemoveAll(this);
+		InventoryComponent->OnInventoryDeltaNative.AddUObject(this, &UInventoryGridWidget::HandleInventoryDelta);
 	}
 }
 
@@ -202,51 +289,111 @@ void UInventoryGridWidget::Refresh()
 	}
 
 	GridCanvasPanel->ClearChildren();
+	ItemWidgets.Reset();
 
 	// Карта уникальных предметов -> их TopLeft tile
 	TMap<UItemObject*, FTile> ItemToTile;
 	GetItemTileMap(ItemToTile);
 
-	APlayerController* PC = GetOwningPlayer();
-
 	for (const TPair<UItemObject*, FTile>& Pair : ItemToTile)
 	{
-		UItemObject* Item = Pair.Key;
-		const FTile& Tile = Pair.Value;
-		if (!IsValid(Item))
+		if (IsValid(Pair.Key))
 		{
+			CreateItemWidget(Pair.Key, Pair.Value);
+		}
+	}
+}
+
+void UInventoryGridWidget::HandleInventoryDelta(const FInventoryDelta& Delta)
+{
+	if (!IsValid(GridCanvasPanel) || !IsValid(InventoryComponent))
+	{
+		return;
+	}
+
+	// Поменялся размер грида — проще перестроить все
+	if (Delta.bFullRefresh)
+	{
+		CreateLineSegments();
+		Refresh();
+		return;
+	}
+
+	for (const FInventoryItemDelta& Entry : Delta.Items)
+	{
+		UItemObject* Item = Entry.Item;
+		TObjectPtr<UInventoryItemWidget>* Found = ItemWidgets.Find(Item);
+		UInventoryItemWidget* ItemWidget = Found ? Found->Get() : nullptr;
+
+		if (!Entry.bHasPlacement)
+		{
+			if (IsValid(ItemWidget))
+			{
+				ItemWidget->RemoveFromParent();
+			}
+			ItemWidgets.Remove(Item);
 			continue;
 		}
 
-		// Создаем виджет предмета
-		UClass* UseClass = ItemWidgetClass ? ItemWidgetClass.Get() : UInventoryItemWidget::StaticClass();
-		UInventoryItemWidget* ItemWidget = CreateWidget<UInventoryItemWidget>(PC, UseClass);
 		if (!IsValid(ItemWidget))
 		{
+			if (IsValid(Item))
+			{
+				CreateItemWidget(Item, Entry.NewPlacement.TopLeftTile);
+			}
 			continue;
 		}
 
-		ItemWidget->ItemObject = Item;
-		ItemWidget->TileSize = TileSize;
-		ItemWidget->InventoryComponent = InventoryComponent;
-		ItemWidget->Refresh();
-
-		// Подписываемся на события Use/Delete из item widget
-		ItemWidget->OnUseSelectedItem.RemoveAll(this);
-		ItemWidget->OnDeleteSelectedItem.RemoveAll(this);
-		ItemWidget->OnUseSelectedItem.AddDynamic(this, &UInventoryGridWidget::OnItemUsed);
-		ItemWidget->OnDeleteSelectedItem.AddDynamic(this, &UInventoryGridWidget::OnItemRemoved);
+		if (Entry.bMoved)
+		{
+			if (UCanvasPanelSlot* GridSlot = Cast<UCanvasPanelSlot>(ItemWidget->Slot))
+			{
+				const FTile& Tile = Entry.NewPlacement.TopLeftTile;
+				GridSlot->SetPosition(FVector2D(Tile.X * TileSize, Tile.Y * TileSize));
+			}
+		}
 
-		// Добавляем в CanvasPanel
-		UCanvasPanelSlot* GridSlot = Cast<UCanvasPanelSlot>(GridCanvasPanel->AddChild(ItemWidget));
-		if (!GridSlot)
+		// Поворот меняет размер, стак/патроны — подписи
+		if (Entry.bRotated || Entry.bStateChanged)
 		{
-			continue;
+			ItemWidget->Refresh();
 		}
+	}
+}
 
-		GridSlot->SetAutoSize(true);
-		GridSlot->SetPosition(FVector2D(Tile.X * TileSize, Tile.Y * TileSize));
+UInventoryItemWidget* UInventoryGridWidget::CreateItemWidget(UItemObject* Item, const FTile& Tile)
+{
+	// Создаем виджет предмета
+	UClass* UseClass = ItemWidgetClass ? ItemWidgetClass.Get() : UInventoryItemWidget::StaticClass();
+	UInventoryItemWidget* ItemWidget = CreateWidget<UInventoryItemWidget>(GetOwningPlayer(), UseClass);
+	if (!IsValid(ItemWidget))
+	{
+		return nullptr;
 	}
+
+	ItemWidget->ItemObject = Item;
+	ItemWidget->TileSize = TileSize;
+	ItemWidget->InventoryComponent = InventoryComponent;
+	ItemWidget->Refresh();
+
+	// Подписываемся на события Use/Delete из item widget
+	ItemWidget->OnUseSelectedItem.RemoveAll(this);
+	ItemWidget->OnDeleteSelectedItem.RemoveAll(this);
+	ItemWidget->OnUseSelectedItem.AddDynamic(this, &UInventoryGridWidget::OnItemUsed);
+	ItemWidget->OnDeleteSelectedItem.AddDynamic(this, &UInventoryGridWidget::OnItemRemoved);
+
+	// Добавляем в CanvasPanel
+	UCanvasPanelSlot* GridSlot = Cast<UCanvasPanelSlot>(GridCanvasPanel->AddChild(ItemWidget));
+	if (!GridSlot)
+	{
+		return ItemWidget;
+	}
+
+	GridSlot->SetAutoSize(true);
+	GridSlot->SetPosition(FVector2D(Tile.X * TileSize, Tile.Y * TileSize));
+
+	ItemWidgets.Add(Item, ItemWidget);
+	return ItemWidget;
 }
 
 bool UInventoryGridWidget::GetTopLeftTileForItem(UItemObject* ItemObject, FTile& OutTile) const
@@ -258,19 +405,15 @@ bool UInventoryGridWidget::GetTopLeftTileForItem(UItemObject* ItemObject, FTile&
 		return false;
 	}
 
-	// Items — 1D массив клеток (row-major). Первая найденная клетка будет TopLeft.
-	const TArray<TObjectPtr<UItemObject>>& Cells = InventoryComponent->Items;
-
-	for (int32 Index = 0; Index < Cells.Num(); ++Index)
+	// TopLeft берем из таблицы размещений инвентаря (O(1), без обхода клеток)
+	FInventoryItemPlacement Placement;
+	if (!InventoryComponent->GetItemPlacement(ItemObject, Placement))
 	{
-		if (Cells[Index] == ItemObject)
-		{
-			OutTile = InventoryComponent->IndexToTile(Index);
-			return true;
-		}
+		return false;
 	}
 
-	return false;
+	OutTile = Placement.TopLeftTile;
+	return true;
 }
 
 void UInventoryGridWidget::GetItemTileMap(TMap<UItemObject*, FTile>& OutMap) const
@@ -282,26 +425,17 @@ void UInventoryGridWidget::GetItemTileMap(TMap<UItemObject*, FTile>& OutMap) con
 		return;
 	}
 
-	// Items — массив клеток (1D)
-	const TArray<TObjectPtr<UItemObject>>& Cells = InventoryComponent->Items;
+	// Каждый предмет ровно один раз — в его TopLeft
+	const TMap<TObjectPtr<UItemObject>, FInventoryItemPlacement>& Placements = InventoryComponent->GetPlacements();
+	OutMap.Reserve(Placements.Num());
 
-	// Чтобы добавить каждый предмет только 1 раз (в его TopLeft)
-	for (int32 Index = 0; Index < Cells.Num(); ++Index)
+	for (const TPair<TObjectPtr<UItemObject>, FInventoryItemPlacement>& Pair : Placements)
 	{
-		UItemObject* Item = Cells[Index].Get();
-		if (!IsValid(Item))
+		UItemObject* Item = Pair.Key.Get();
+		if (IsValid(Item))
 		{
-			continue;
+			OutMap.Add(Item, Pair.Value.TopLeftTile);
 		}
-
-		// Если уже добавляли этот Item — пропускаем (значит это не его TopLeft клетка)
-		if (OutMap.Contains(Item))
-		{
-			continue;
-		}
-
-		const FTile Tile = InventoryComponent->IndexToTile(Index);
-		OutMap.Add(Item, Tile);
 	}
 }
 
@@ -325,6 +459,9 @@ void UInventoryGridWidget::NativeOnDragEnter(const FGeometry& InGeometry, const
 	Super::NativeOnDragEnter(InGeometry, InDragDropEvent, InOperation);
 
 	bDrawDropLocation = true;
+	DropMask.Reset();
+	DropMaskItem.Reset();
+	HighlightApplyTargets(GetPayload(InOperation));
 	Invalidate(EInvalidateWidget::Paint);
 }
 
@@ -333,6 +470,9 @@ void UInventoryGridWidget::NativeOnDragLeave(const FDragDropEvent& InDragDropEve
 	Super::NativeOnDragLeave(InDragDropEvent, InOperation);
 
 	bDrawDropLocation = false;
+	DropMask.Reset();
+	DropMaskItem.Reset();
+	ClearApplyTargetHighlights();
 	Invalidate(EInvalidateWidget::Paint);
 }
 
@@ -387,10 +527,27 @@ bool UInventoryGridWidget::NativeOnDragOver(const FGeometry& InGeometry, const F
 	const int32 MaxX = FMath::Max(0, InventoryComponent->Columns - DimsX);
 	const int32 MaxY = FMath::Max(0, InventoryComponent->Rows - DimsY);
 
-	DraggedItemTopLeftTileX = FMath::Clamp(HoverTileX - OffsetX, 0, MaxX);
-	DraggedItemTopLeftTileY = FMath::Clamp(HoverTileY - OffsetY, 0, MaxY);
+	int32 TopLeftX = FMath::Clamp(HoverTileX - OffsetX, 0, MaxX);
+	int32 TopLeftY = FMath::Clamp(HoverTileY - OffsetY, 0, MaxY);
+
+	// Маска — один раз на drag (и при повороте/изменении грида), дальше проверка O(1)
+	const bool bMaskRebuilt = UpdateDropMask(Item, InOperation);
+
+	bool bValid = DropMask.IsValid(TopLeftX, TopLeftY);
+	if (!bValid && bSnapToNearestValid)
+	{
+		bValid = DropMask.FindNearestValid(TopLeftX, TopLeftY, DropSnapRadius, TopLeftX, TopLeftY);
+	}
+
+	// Перерисовка только когда подсветка реально сдвинулась / сменила цвет / размер
+	if (bMaskRebuilt || bValid != bDropLocationValid || TopLeftX != DraggedItemTopLeftTileX || TopLeftY != DraggedItemTopLeftTileY)
+	{
+		DraggedItemTopLeftTileX = TopLeftX;
+		DraggedItemTopLeftTileY = TopLeftY;
+		bDropLocationValid = bValid;
+		Invalidate(EInvalidateWidget::Paint);
+	}
 
-	Invalidate(EInvalidateWidget::Paint);
 	return true;
 }
 
@@ -405,6 +562,8 @@ void UInventoryGridWidget::NativeConstruct()
 bool UInventoryGridWidget::NativeOnDrop(const FGeometry& InGeometry, const FDragDropEvent& InDragDropEvent,
 	UDragDropOperation* InOperation)
 {
+	ClearApplyTargetHighlights();
+
 	if (!IsValid(InventoryComponent))
 	{
 		return false;
@@ -422,8 +581,12 @@ bool UInventoryGridWidget::NativeOnDrop(const FGeometry& InGeometry, const FDrag
 	// Move внутри того же инвентаря: сначала временно убираем предмет, чтобы освободить его клетки
 	const UInventoryItemDragDropOperation* InvOp = Cast<UInventoryItemDragDropOperation>(InOperation);
 	const bool bFromSameInventory = InvOp && (InvOp->SourceInventory == InventoryComponent);
+
 	const int32 SourceTopLeftIndex = bFromSameInventory ? InvOp->SourceTopLeftIndex : INDEX_NONE;
 
+	// Remove + Add — одна транзакция: одно обновление UI
+	FInventoryTransactionScope Transaction(InventoryComponent);
+
 	if (bFromSameInventory)
 	{
 		InventoryComponent->RemoveItem(Item);
@@ -433,10 +596,8 @@ bool UInventoryGridWidget::NativeOnDrop(const FGeometry& InGeometry, const FDrag
 	if (IsRoomAvailableForPayload(Payload, InOperation))
 	{
 		const int32 TopLeftIndex = InventoryComponent->TileToIndex(FTile(DraggedItemTopLeftTileX, DraggedItemTopLeftTileY));
-		if (TopLeftIndex != INDEX_NONE)
+		if (TopLeftIndex != INDEX_NONE && InventoryComponent->AddItemAt(Item, TopLeftIndex))
 		{
-			InventoryComponent->AddItemAt(Item, TopLeftIndex);
-
 			// if dragged from EquipmentSlot -> clear it immediately
 			if (UEquipmentDragDropOperation* EquipOp = Cast<UEquipmentDragDropOperation>(InOperation))
 			{
@@ -445,23 +606,27 @@ bool UInventoryGridWidget::NativeOnDrop(const FGeometry& InGeometry, const FDrag
 					EquipOp->SourceEquipment->UnequipSlot(EquipOp->SourceSlotId, false);
 				}
 			}
-			
+
+			Transaction.Commit();
 			return true;
 		}
 	}
 
-	// Если это было перемещение внутри того же инвентаря, а место не найдено — возвращаем обратно
+	// Перемещение внутри того же инвентаря, а места нет — возвращаем на исходное место вручную:
+	// из грида предмет убран еще в начале drag (вне транзакции), откат вернул бы его в "не в гриде"
 	if (bFromSameInventory)
 	{
-		if (SourceTopLeftIndex != INDEX_NONE)
-		{
-			InventoryComponent->AddItemAt(Item, SourceTopLeftIndex);
-		}
-		else
+		const bool bRestored = SourceTopLeftIndex != INDEX_NONE && InventoryComponent->IsRoomAvailable(Item, SourceTopLeftIndex)
+			&& InventoryComponent->AddItemAt(Item, SourceTopLeftIndex);
+		if (!bRestored)
 		{
 			InventoryComponent->TryAddItem(Item);
 		}
-		return true;
+
+		Transaction.Commit();
+
+		// Дроп не удался: handled только если предмет снова лежит в гриде
+		return InventoryComponent->ContainsItem(Item);
 	}
 
 	// Иначе -> TryAddItem. Если не удалось -> DropItem в мир.
@@ -481,6 +646,7 @@ bool UInventoryGridWidget::NativeOnDrop(const FGeometry& InGeometry, const FDrag
 		}
 	}
 
+	Transaction.Commit();
 	return true;
 }
 
@@ -30,13 +30,13 @@ FSlateBrush UInventoryItemWidget::GetIconImage() const
 	UTexture2D* IconTex = nullptr;
 
 	// Если предмет повернут и есть IconRotated — используем её
-	if (ItemObject->Runtime.bIsRotated && IsValid(ItemObject->ItemDetails.IconRotated))
+	if (ItemObject->Runtime.bIsRotated && IsValid(ItemObject->GetItemDetails().IconRotated))
 	{
-		IconTex = ItemObject->ItemDetails.IconRotated;
+		IconTex = ItemObject->GetItemDetails().IconRotated;
 	}
 	else
 	{
-		IconTex = ItemObject->ItemDetails.ItemIcon;
+		IconTex = ItemObject->GetItemDetails().ItemIcon;
 	}
 
 	if (IsValid(IconTex))
@@ -200,7 +200,27 @@ void UInventoryItemWidget::NativeOnMouseLeave(const FPointerEvent& InMouseEvent)
 	// EventOnMouseLeave
 	if (IsValid(BackgroundBorder))
 	{
-		BackgroundBorder->SetBrushColor(FLinearColor(1.f, 1.f, 1.f, 0.5f));
+		BackgroundBorder->SetBrushColor(GetIdleBorderColor());
+	}
+}
+
+FLinearColor UInventoryItemWidget::GetIdleBorderColor() const
+{
+	return bApplyTargetHighlighted ? ApplyTargetColor : FLinearColor(1.f, 1.f, 1.f, 0.5f);
+}
+
+void UInventoryItemWidget::SetApplyTargetHighlight(bool bHighlighted)
+{
+	if (bApplyTargetHighlighted == bHighlighted)
+	{
+		return;
+	}
+
+	bApplyTargetHighlighted = bHighlighted;
+
+	if (IsValid(BackgroundBorder) && !IsHovered())
+	{
+		BackgroundBorder->SetBrushColor(GetIdleBorderColor());
 	}
 }
 
@@ -242,7 +262,7 @@ void UInventoryItemWidget::RefreshDurabilityVisual()
 		return;
 	}
 
-	if (!IsValid(ItemObject) || !ItemObject->DurabilityConfig.bHasDurability || ItemObject->DurabilityConfig.MaxDurability <= KINDA_SMALL_NUMBER)
+	if (!IsValid(ItemObject) || !ItemObject->GetDurabilityConfig().bHasDurability || ItemObject->GetDurabilityConfig().MaxDurability <= KINDA_SMALL_NUMBER)
 	{
 		DurabilityBar->SetVisibility(ESlateVisibility::Collapsed);
 		DurabilityBar->SetPercent(1.f);
@@ -260,12 +280,12 @@ float UInventoryItemWidget::CalcDurability(const UItemObject* Item)
 		return 0.f;
 	}
 
-	if (!Item->DurabilityConfig.bHasDurability)
+	if (!Item->GetDurabilityConfig().bHasDurability)
 	{
 		return 1.f;
 	}
 
-	const float MaxD = Item->DurabilityConfig.MaxDurability;
+	const float MaxD = Item->GetDurabilityConfig().MaxDurability;
 	if (MaxD <= KINDA_SMALL_NUMBER)
 	{
 		return 0.f;
@@ -26,13 +26,13 @@ void UInventorySlotWidget::SetEquipmentRef(UEquipmentComponent* InEquipment)
 	// --- UNBIND OLD ---
 	if (IsValid(EquipmentRef))
 	{
-		EquipmentRef->OnEquipmentSlotChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleEquipmentChanged);
-		EquipmentRef->OnEquipmentActiveSlotChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleActiveSlotChanged);
-		EquipmentRef->OnEquipmentSelectedSlotChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleSelectedSlotChanged);
+		EquipmentRef->RemoveSlotListeners(this);
+		EquipmentRef->OnEquipmentActiveSlotChangedNative.RemoveAll(this);
+		EquipmentRef->OnEquipmentSelectedSlotChangedNative.RemoveAll(this);
 	}
 	if (IsValid(InventoryRefCached))
 	{
-		InventoryRefCached->OnInventoryChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleInventoryChanged);
+		InventoryRefCached->OnInventoryDeltaNative.RemoveAll(this);
 		InventoryRefCached = nullptr;
 	}
 
@@ -41,13 +41,13 @@ void UInventorySlotWidget::SetEquipmentRef(UEquipmentComponent* InEquipment)
 	// --- BIND NEW ---
 	if (IsValid(EquipmentRef))
 	{
-		EquipmentRef->OnEquipmentSlotChanged.AddDynamic(this, &UInventorySlotWidget::HandleEquipmentChanged);
-		EquipmentRef->OnEquipmentSelectedSlotChanged.AddDynamic(this, &UInventorySlotWidget::HandleSelectedSlotChanged);
+		EquipmentRef->OnSlotChangedNative(SlotId).AddUObject(this, &UInventorySlotWidget::HandleEquipmentChanged);
+		EquipmentRef->OnEquipmentSelectedSlotChangedNative.AddUObject(this, &UInventorySlotWidget::HandleSelectedSlotChanged);
 
 		InventoryRefCached = EquipmentRef->GetInventoryRef();
 		if (IsValid(InventoryRefCached))
 		{
-			InventoryRefCached->OnInventoryChanged.AddDynamic(this, &UInventorySlotWidget::HandleInventoryChanged);
+			InventoryRefCached->OnInventoryDeltaNative.AddUObject(this, &UInventorySlotWidget::HandleInventoryDelta);
 		}
 	}
 
@@ -141,28 +141,28 @@ void UInventorySlotWidget::NativeConstruct()
 
 	if (IsValid(EquipmentRef))
 	{
-		EquipmentRef->OnEquipmentSlotChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleEquipmentChanged);
-		EquipmentRef->OnEquipmentSlotChanged.AddDynamic(this, &UInventorySlotWidget::HandleEquipmentChanged);
+		EquipmentRef->RemoveSlotListeners(this);
+		EquipmentRef->OnSlotChangedNative(SlotId).AddUObject(this, &UInventorySlotWidget::HandleEquipmentChanged);
 
-		EquipmentRef->OnEquipmentActiveSlotChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleActiveSlotChanged);
-		EquipmentRef->OnEquipmentActiveSlotChanged.AddDynamic(this, &UInventorySlotWidget::HandleActiveSlotChanged);
+		EquipmentRef->OnEquipmentActiveSlotChangedNative.RemoveAll(this);
+		EquipmentRef->OnEquipmentActiveSlotChangedNative.AddUObject(this, &UInventorySlotWidget::HandleActiveSlotChanged);
 
-		EquipmentRef->OnEquipmentSelectedSlotChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleSelectedSlotChanged);
+		EquipmentRef->OnEquipmentSelectedSlotChangedNative.RemoveAll(this);
 
 		UInventoryComponent* Inv = EquipmentRef->GetInventoryRef();
 		if (InventoryRefCached != Inv)
 		{
 			if (IsValid(InventoryRefCached))
 			{
-				InventoryRefCached->OnInventoryChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleInventoryChanged);
+				InventoryRefCached->OnInventoryDeltaNative.RemoveAll(this);
 			}
 			InventoryRefCached = Inv;
 		}
 
 		if (IsValid(InventoryRefCached))
 		{
-			InventoryRefCached->OnInventoryChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleInventoryChanged);
-			InventoryRefCached->OnInventoryChanged.AddDynamic(this, &UInventorySlotWidget::HandleInventoryChanged);
+			InventoryRefCached->OnInventoryDeltaNative.RemoveAll(this);
+			InventoryRefCached->OnInventoryDeltaNative.AddUObject(this, &UInventorySlotWidget::HandleInventoryDelta);
 		}
 	}
 
@@ -174,13 +174,13 @@ void UInventorySlotWidget::NativeDestruct()
 {
 	if (IsValid(EquipmentRef))
 	{
-		EquipmentRef->OnEquipmentSlotChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleEquipmentChanged);
-		EquipmentRef->OnEquipmentActiveSlotChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleActiveSlotChanged);
+		EquipmentRef->RemoveSlotListeners(this);
+		EquipmentRef->OnEquipmentActiveSlotChangedNative.RemoveAll(this);
 	}
 
 	if (IsValid(InventoryRefCached))
 	{
-		InventoryRefCached->OnInventoryChanged.RemoveDynamic(this, &UInventorySlotWidget::HandleInventoryChanged);
+		InventoryRefCached->OnInventoryDeltaNative.RemoveAll(this);
 		InventoryRefCached = nullptr;
 	}
 
@@ -354,11 +354,7 @@ void UInventorySlotWidget::NativeOnDragCancelled(const FDragDropEvent& InDragDro
 
 void UInventorySlotWidget::HandleEquipmentChanged(EEquipmentSlotId ChangedSlot, UItemObject* NewItem)
 {
-	if (ChangedSlot != SlotId)
-	{
-		return;
-	}
-
+	// Подписка на свой слот (OnSlotChangedNative) — чужие сюда не приходят
 	RestoreAfterDrag();
 	RefreshSlot(nullptr, FLinearColor::White);
 }
@@ -393,7 +389,7 @@ void UInventorySlotWidget::SetIconFromItem(UItemObject* Item, FLinearColor InCol
 		return;
 	}
 
-	if (UTexture2D* Tex = Item->ItemDetails.ItemIcon)
+	if (UTexture2D* Tex = Item->GetItemDetails().ItemIcon)
 	{
 		Icon->SetBrushFromTexture(Tex, true);
 		Icon->SetColorAndOpacity(InColorAndOpacity);
@@ -478,7 +474,7 @@ void UInventorySlotWidget::RefreshDurabilityVisual(UItemObject* Item)
 		return;
 	}
 
-	if (!IsValid(Item) || !Item->DurabilityConfig.bHasDurability || Item->DurabilityConfig.MaxDurability <= KINDA_SMALL_NUMBER)
+	if (!IsValid(Item) || !Item->GetDurabilityConfig().bHasDurability || Item->GetDurabilityConfig().MaxDurability <= KINDA_SMALL_NUMBER)
 	{
 		DurabilityBar->SetVisibility(ESlateVisibility::Collapsed);
 		DurabilityBar->SetPercent(1.f);
@@ -496,12 +492,12 @@ float UInventorySlotWidget::CalcDurability(const UItemObject* Item)
 		return 0.f;
 	}
 
-	if (!Item->DurabilityConfig.bHasDurability)
+	if (!Item->GetDurabilityConfig().bHasDurability)
 	{
 		return 1.f;
 	}
 
-	const float MaxD = Item->DurabilityConfig.MaxDurability;
+	const float MaxD = Item->GetDurabilityConfig().MaxDurability;
 	if (MaxD <= KINDA_SMALL_NUMBER)
 	{
 		return 0.f;
@@ -510,9 +506,14 @@ float UInventorySlotWidget::CalcDurability(const UItemObject* Item)
 	return FMath::Clamp(Item->Runtime.CurrDurability / MaxD, 0.f, 1.f);
 }
 
-void UInventorySlotWidget::HandleInventoryChanged()
+void UInventorySlotWidget::HandleInventoryDelta(const FInventoryDelta& Delta)
 {
-	RefreshDurabilityVisual(GetItem());
+	// Только если в дельте наш предмет
+	UItemObject* Item = GetItem();
+	if (Delta.bFullRefresh || Delta.Contains(Item))
+	{
+		RefreshDurabilityVisual(Item);
+	}
 }
 
 void UInventorySlotWidget::RestoreAfterDrag()
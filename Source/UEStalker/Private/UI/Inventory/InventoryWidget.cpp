@@ -37,80 +37,14 @@ bool UInventoryWidget::TryAutoEquipItem(UItemObject* ItemObject)
 		return false;
 	}
 
-	const EItemCategory Cat = ItemObject->ItemDetails.ItemCategory;
-	const EItemSubCategory Sub = ItemObject->ItemDetails.ItemSubCategory;
-
-	TArray<EEquipmentSlotId> Candidates;
-
-	switch (Cat)
-	{
-		case EItemCategory::ItemCat_Armor:
-			Candidates = { EEquipmentSlotId::ArmorSlot };
-			break;
-		case EItemCategory::ItemCat_Helmet:
-			Candidates = { EEquipmentSlotId::HelmetSlot };
-			break;
-		case EItemCategory::ItemCat_Backpack:
-			Candidates = { EEquipmentSlotId::BackpackSlot };
-			break;
-
-		case EItemCategory::ItemCat_Weapons:
-			if (Sub == EItemSubCategory::ItemSubCat_Weapons_HG)
-			{
-				Candidates = { EEquipmentSlotId::PistolSlot };
-			}
-			else if (Sub == EItemSubCategory::ItemSubCat_Weapons_Knife)
-			{
-				Candidates = { EEquipmentSlotId::KnifeSlot };
-			}
-			else if (Sub == EItemSubCategory::ItemSubCat_Weapons_Grenade)
-			{
-				Candidates = { EEquipmentSlotId::GrenadePrimarySlot, EEquipmentSlotId::GrenadeSecondarySlot };
-			}
-			else
-			{
-				Candidates = { EEquipmentSlotId::PrimaryWeaponSlot, EEquipmentSlotId::SecondaryWeaponSlot };
-			}
-			break;
-
-		case EItemCategory::ItemCat_UsableItems:
-			// Devices by default
-			Candidates = { EEquipmentSlotId::DeviceSlot1, EEquipmentSlotId::DeviceSlot2, EEquipmentSlotId::DeviceSlot3 };
-			break;
-
-		default:
-			break;
-	}
-
-	// Artefacts / Modules
-	if (Candidates.Num() == 0)
+	// Все подходящие слоты разом (маска ассета минус замки/блокировки/броня), по порядку слотов
+	uint32 Candidates = EquipComp->GetEquippableSlotMask(ItemObject);
+	while (Candidates != 0)
 	{
-		if (Sub == EItemSubCategory::ItemSubCat_Items_Artefacts || Sub == EItemSubCategory::ItemSubCat_Items_Modules)
-		{
-			Candidates = {
-				EEquipmentSlotId::ItemSlot1,
-				EEquipmentSlotId::ItemSlot2,
-				EEquipmentSlotId::ItemSlot3,
-				EEquipmentSlotId::ItemSlot4,
-				EEquipmentSlotId::ItemSlot5
-			};
-		}
-		// Quick slots
-		else if (Sub == EItemSubCategory::ItemSubCat_Items_Food ||
-				 Sub == EItemSubCategory::ItemSubCat_Items_Water ||
-				 Sub == EItemSubCategory::ItemSubCat_Items_Medicine)
-		{
-			Candidates = {
-				EEquipmentSlotId::QuickSlot1,
-				EEquipmentSlotId::QuickSlot2,
-				EEquipmentSlotId::QuickSlot3,
-				EEquipmentSlotId::QuickSlot4
-			};
-		}
-	}
+		const EEquipmentSlotId CandSlot = static_cast<EEquipmentSlotId>(FMath::CountTrailingZeros(Candidates));
+		Candidates &= Candidates - 1u;
 
-	for (const EEquipmentSlotId CandSlot : Candidates)
-	{
+		// Занятые слоты EquipToSlot пропускает сам (без свапа)
 		if (EquipComp->EquipToSlot(CandSlot, ItemObject, true))
 		{
 			return true;
@@ -186,7 +120,8 @@ void UInventoryWidget::SetupWithInventory()
 	EquipmentComponent = EquipComp;
 	if (IsValid(EquipmentComponent))
 	{
-		EquipmentComponent->OnEquipmentSlotChanged.AddDynamic(this, &UInventoryWidget::OnEquipmentSlotChanged);
+		EquipmentComponent->OnEquipmentChangedNative.RemoveAll(this);
+		EquipmentComponent->OnEquipmentChangedNative.AddUObject(this, &UInventoryWidget::OnEquipmentChanged);
 	}
 
 	auto BindSlot = [&](UInventorySlotWidget* EquipSlot, EEquipmentSlotId InSlotId)
@@ -247,19 +182,40 @@ void UInventoryWidget::SetupWithInventory()
 	}
 
 	// Bind OnInventoryChanged -> OnInventoryChangedEvent
-	InventoryComponent->OnInventoryChanged.AddDynamic(this, &UInventoryWidget::OnInventoryChangedEvent);
+	InventoryComponent->OnInventoryChangedNative.RemoveAll(this);
+	InventoryComponent->OnInventoryChangedNative.AddUObject(this, &UInventoryWidget::RequestPanelRefresh);
 
 	// первичное обновление
 	OnInventoryChangedEvent();
 }
 
-void UInventoryWidget::OnEquipmentSlotChanged(EEquipmentSlotId SlotId, UItemObject* Item)
+void UInventoryWidget::OnEquipmentChanged(const FEquipmentChangeSet& ChangeSet)
+{
+	// Equipment changed -> refresh UI (вес экипировки уже учтен журналом инвентаря)
+	RequestPanelRefresh();
+}
+
+void UInventoryWidget::RequestPanelRefresh()
+{
+	// Экипировка + инвентарь за кадр -> одно обновление (в NativeTick этого же кадра).
+	// Не таймер мира: он стоит на паузе, а инвентарь открывают именно на паузе
+	bPanelRefreshPending = true;
+}
+
+void UInventoryWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
-	// Equipment changed -> invalidate cached weight and refresh UI
-	if (IsValid(InventoryComponent))
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	// Скрытая панель не тикает — накопленное применится, когда ее покажут
+	if (bPanelRefreshPending)
 	{
-		InventoryComponent->InvalidateWeight();
+		FlushPanelRefresh();
 	}
+}
+
+void UInventoryWidget::FlushPanelRefresh()
+{
+	bPanelRefreshPending = false;
 	OnInventoryChangedEvent();
 }
 
@@ -270,11 +226,7 @@ FEventReply UInventoryWidget::HandleBorderMouseDown(FGeometry MyGeometry, const
 
 void UInventoryWidget::OnInventoryChangedEvent()
 {
-	if (IsValid(WBGridInventory))
-	{
-		WBGridInventory->Refresh();
-	}
-
+	// Грид патчится сам по OnInventoryDelta — здесь только вес
 	if (!IsValid(InventoryComponent))
 	{
 		return;
@@ -283,6 +235,14 @@ void UInventoryWidget::OnInventoryChangedEvent()
 	const float Weight = InventoryComponent->GetTotalWeight();
 	const float MaxWeight = InventoryComponent->GetMaxCarryWeight();
 
+	if (Weight == ShownWeight && MaxWeight == ShownMaxWeight)
+	{
+		return;
+	}
+
+	ShownWeight = Weight;
+	ShownMaxWeight = MaxWeight;
+
 	// Формат 1 знак после запятой (можно поменять на "%.0f" если нужно без дробей)
 	if (IsValid(TextWeight))
 	{
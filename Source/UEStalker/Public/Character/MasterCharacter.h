@@ -294,8 +294,7 @@ public:
 	void OnArmsReloadMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
 protected:
-	UFUNCTION()
-	void OnEquipmentSlotChanged(EEquipmentSlotId SlotId, UItemObject* Item);
+	void OnEquipmentChanged(const FEquipmentChangeSet& ChangeSet);
 
 	void RebuildHeldActors();
 	void UpdateWeaponStateFromActiveSlot();
@@ -3,10 +3,12 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Items/MasterItemEnums.h"
+#include "Items/MasterItemStructs.h"
 #include "EquipmentComponent.generated.h"
 
 class UItemObject;
 class UInventoryComponent;
+class UMasterItemDataAsset;
 
 UENUM(BlueprintType)
 enum class EEquipmentSlotId : uint8
@@ -49,6 +51,8 @@ enum class EEquipmentSlotId : uint8
 	Slot_Count UMETA(Hidden)
 };
 
+static_assert(static_cast<int32>(EEquipmentSlotId::Slot_Count) <= 32, "Slot masks are uint32");
+
 USTRUCT(BlueprintType)
 struct FEquipmentSlotState
 {
@@ -61,10 +65,108 @@ struct FEquipmentSlotState
 	bool bLocked = false;
 };
 
+/** Канал суммарных статов экипировки (индекс в FEquipmentStatVector). */
+enum class EEquipmentStatChannel : uint8
+{
+	Radiation,
+	Psi,
+	Chemical,
+	Blow,
+	Electrical,
+	Bullets,
+	Fire,
+	CarryBonus,
+
+	Count
+};
+
+/**
+ * Статы одного предмета/суммы: 7 защит + бонус переноса = 8 float,
+ * выровнено под два SIMD-регистра (сумма слотов — два VectorAdd на слот).
+ */
+struct alignas(16) FEquipmentStatVector
+{
+	float Lanes[static_cast<int32>(EEquipmentStatChannel::Count)] = {};
+
+	FORCEINLINE float Get(EEquipmentStatChannel Channel) const { return Lanes[static_cast<int32>(Channel)]; }
+
+	static FEquipmentStatVector FromOutfit(const FItemOutfitStatsConfig& Config);
+
+	FItemProtectionStats ToProtection() const;
+
+	/** Out = сумма Terms по битам Mask (бит i -> Terms[i]). */
+	static void SumMasked(const FEquipmentStatVector* Terms, int32 NumTerms, uint32 Mask, FEquipmentStatVector& Out);
+
+	bool operator==(const FEquipmentStatVector& Other) const { return FMemory::Memcmp(Lanes, Other.Lanes, sizeof(Lanes)) == 0; }
+	bool operator!=(const FEquipmentStatVector& Other) const { return !(*this == Other); }
+};
+
+/** Итог одной операции над экипировкой (биты = 1 << EEquipmentSlotId). */
+USTRUCT(BlueprintType)
+struct FEquipmentChangeSet
+{
+	GENERATED_BODY()
+
+	/** Слоты, у которых реально сменился предмет, блокировка или замок */
+	UPROPERTY(BlueprintReadOnly, Category="Equipment")
+	TArray<EEquipmentSlotId> ChangedSlots;
+
+	uint32 ItemSlots = 0;
+	uint32 BlockedSlots = 0;
+	uint32 LockedSlots = 0;
+
+	FORCEINLINE uint32 GetChangedMask() const { return ItemSlots | BlockedSlots | LockedSlots; }
+	FORCEINLINE bool IsEmpty() const { return GetChangedMask() == 0; }
+	FORCEINLINE bool Contains(EEquipmentSlotId SlotId) const { return (GetChangedMask() & (1u << static_cast<uint32>(SlotId))) != 0; }
+};
+
+/** Слот пресета: конкретный предмет, а если его уже нет — любой такой же ассет из инвентаря. */
+USTRUCT(BlueprintType)
+struct FEquipmentLoadoutSlot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Equipment|Loadout")
+	EEquipmentSlotId SlotId = EEquipmentSlotId::None;
+
+	/** Подсказка, какой именно экземпляр надеть; берется, только если это все еще Asset (объекты переиспользует пул) */
+	UPROPERTY(BlueprintReadWrite, Category="Equipment|Loadout")
+	TWeakObjectPtr<UItemObject> Item;
+
+	/** nullptr — слот в пресете пустой */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Equipment|Loadout")
+	TObjectPtr<UMasterItemDataAsset> Asset = nullptr;
+};
+
+/** Сохраненный набор экипировки ("стелс", "штурм"): применяется одной операцией. */
+USTRUCT(BlueprintType)
+struct FEquipmentLoadout
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Equipment|Loadout")
+	FName Name;
+
+	/** Слоты, которыми управляет пресет; остальные ApplyLoadout не трогает */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Equipment|Loadout")
+	TArray<FEquipmentLoadoutSlot> Slots;
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnEquipmentSlotChanged, EEquipmentSlotId, SlotId, UItemObject*, Item);
 // Broadcast when ActiveSlot/PrevSlot changes (hover highlight during drag&drop)
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnEquipmentActiveSlotChanged);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnEquipmentSelectedSlotChanged, EEquipmentSlotId, SlotId);
+// Одно уведомление на операцию (EquipToSlot/UnequipSlot/...) со всеми реально измененными слотами
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnEquipmentChanged, const FEquipmentChangeSet&, ChangeSet);
+// Поменялись суммарные защиты/бонус переноса (не чаще раза на операцию)
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnEquipmentStatsChanged);
+
+// Нативные версии для C++ подписчиков (слотов экипировки много — без ProcessEvent на каждый)
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnEquipmentSlotChangedNative, EEquipmentSlotId, UItemObject*);
+DECLARE_MULTICAST_DELEGATE(FOnEquipmentActiveSlotChangedNative);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnEquipmentSelectedSlotChangedNative, EEquipmentSlotId);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnEquipmentChangedNative, const FEquipmentChangeSet&);
+DECLARE_MULTICAST_DELEGATE(FOnEquipmentStatsChangedNative);
 
 UCLASS(ClassGroup=(Inventory), meta=(BlueprintSpawnableComponent))
 class UESTALKER_API UEquipmentComponent : public UActorComponent
@@ -88,6 +190,26 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="Equipment|Events")
 	FOnEquipmentSelectedSlotChanged OnEquipmentSelectedSlotChanged;
 
+	/** Батч: после OnEquipmentSlotChanged по каждому измененному слоту */
+	UPROPERTY(BlueprintAssignable, Category="Equipment|Events")
+	FOnEquipmentChanged OnEquipmentChanged;
+
+	UPROPERTY(BlueprintAssignable, Category="Equipment|Events")
+	FOnEquipmentStatsChanged OnEquipmentStatsChanged;
+
+	// ===== Native events (C++: AddUObject/RemoveAll). Приходят раньше Blueprint-версий =====
+	FOnEquipmentSlotChangedNative OnEquipmentSlotChangedNative;
+	FOnEquipmentActiveSlotChangedNative OnEquipmentActiveSlotChangedNative;
+	FOnEquipmentSelectedSlotChangedNative OnEquipmentSelectedSlotChangedNative;
+	FOnEquipmentChangedNative OnEquipmentChangedNative;
+	FOnEquipmentStatsChangedNative OnEquipmentStatsChangedNative;
+
+	/** Подписка на один слот: вызывается только когда меняется этот слот (UI-слоты не фильтруют чужие). */
+	FOnEquipmentSlotChangedNative& OnSlotChangedNative(EEquipmentSlotId SlotId);
+
+	/** Снять подписчика со всех слотовых делегатов. */
+	void RemoveSlotListeners(const void* UserObject);
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Equipment|Select")
 	EEquipmentSlotId SelectedSlot = EEquipmentSlotId::None;
 
@@ -133,6 +255,22 @@ public:
 	UFUNCTION(BlueprintPure, Category="Equipment")
 	bool CanEquipItemToSlot(UItemObject* Item, EEquipmentSlotId SlotId) const;
 
+	// ===== Slot masks (бит = 1 << EEquipmentSlotId) =====
+
+	static FORCEINLINE uint32 SlotBit(EEquipmentSlotId SlotId) { return 1u << static_cast<uint32>(SlotId); }
+
+	/**
+	 * Слоты, которые принимают предмет по категории/подкатегории (без замков и брони).
+	 * Считается один раз на ассет (UMasterItemDataAsset::GetEquipSlotMask).
+	 */
+	static uint32 ComputeStaticSlotMask(EItemCategory Category, EItemSubCategory SubCategory);
+
+	/** Все слоты, куда предмет можно надеть сейчас: статическая маска минус замки/блокировки/несовместимость с броней. */
+	uint32 GetEquippableSlotMask(const UItemObject* Item) const;
+
+	UFUNCTION(BlueprintPure, Category="Equipment", meta=(DisplayName="Get Equippable Slots"))
+	TArray<EEquipmentSlotId> K2_GetEquippableSlots(UItemObject* Item) const;
+
 	UFUNCTION(BlueprintCallable, Category="Equipment")
 	void SetSlotLocked(EEquipmentSlotId SlotId, bool bLocked);
 
@@ -144,6 +282,75 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Equipment|Blocked")
 	void RebuildBlockedSlots();
 
+	// ===== Change batching =====
+	/**
+	 * Изменения внутри Begin/End копятся; на внешнем EndChangeBatch — сравнение со снимком на входе
+	 * и одна рассылка только по слотам, у которых что-то поменялось. Удобнее через FEquipmentChangeScope.
+	 */
+	void BeginChangeBatch();
+	void EndChangeBatch();
+
+	FORCEINLINE bool IsInChangeBatch() const { return ChangeBatchDepth > 0; }
+
+	// ===== Stats (броня, шлем, рюкзак, артефакты/модули) =====
+	/** Слоты, которые дают статы (OutfitStatsConfig предмета); заблокированные слоты артефактов не считаются. */
+	static uint32 GetStatSlotMask();
+
+	/** Сумма по надетому — кэш, пересчитывается только при смене предметов/блокировок. */
+	FORCEINLINE const FEquipmentStatVector& GetStatTotals() const { return StatTotals; }
+
+	FORCEINLINE float GetProtection(EEquipmentStatChannel Channel) const { return StatTotals.Get(Channel); }
+
+	UFUNCTION(BlueprintPure, Category="Equipment|Stats")
+	FItemProtectionStats GetProtectionStats() const { return StatTotals.ToProtection(); }
+
+	UFUNCTION(BlueprintPure, Category="Equipment|Stats")
+	float GetCarryBonusWeight() const { return StatTotals.Get(EEquipmentStatChannel::CarryBonus); }
+
+	/** Статы надетого предмета поменялись в обход слота (апгрейд/override) — перечитать вклад слота. */
+	UFUNCTION(BlueprintCallable, Category="Equipment|Stats")
+	void RefreshSlotStats(EEquipmentSlotId SlotId);
+
+	/** То же по предмету: если он надет — перечитать вклад его слота. */
+	UFUNCTION(BlueprintCallable, Category="Equipment|Stats")
+	void RefreshItemStats(const UItemObject* Item);
+
+	// ===== Loadouts =====
+	/** Пресеты экипировки (по имени). */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Equipment|Loadout")
+	TArray<FEquipmentLoadout> Loadouts;
+
+	/** Запомнить текущую экипировку (все незапертые слоты, пустые тоже) под именем Name; одноименный пресет заменяется. */
+	UFUNCTION(BlueprintCallable, Category="Equipment|Loadout")
+	void SaveLoadout(FName Name);
+
+	UFUNCTION(BlueprintCallable, Category="Equipment|Loadout")
+	bool RemoveLoadout(FName Name);
+
+	UFUNCTION(BlueprintPure, Category="Equipment|Loadout")
+	bool HasLoadout(FName Name) const { return FindLoadout(Name) != nullptr; }
+
+	const FEquipmentLoadout* FindLoadout(FName Name) const;
+
+	/**
+	 * Надеть пресет одной операцией: итоговое состояние планируется целиком (броня -> шлем/рюкзак -> слоты артефактов),
+	 * снятое возвращается в инвентарь пачкой, блокировки пересобираются один раз, одно уведомление и один звук.
+	 * Не нашедшиеся/несовместимые предметы пропускаются (OutSkippedSlots), слот остается как был.
+	 * false — снятое не влезло в инвентарь: всё откатывается.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Equipment|Loadout")
+	bool ApplyLoadout(FName Name, int32& OutSkippedSlots);
+
+	// ===== Content hash =====
+	/**
+	 * 64-битный хэш экипировки: предметы по слотам вместе с их содержимым и замки слотов.
+	 * Слот обновляет его за O(1); равный хэш — можно пропустить обновление/сохранение.
+	 */
+	uint64 GetContentHash() const;
+
+	UFUNCTION(BlueprintPure, Category="Equipment", meta=(DisplayName="Get Content Hash"))
+	int64 K2_GetContentHash() const { return static_cast<int64>(GetContentHash()); }
+
 	// ===== References =====
 	UFUNCTION(BlueprintPure, Category="Equipment")
 	UInventoryComponent* GetInventoryRef() const { return InventoryRef; }
@@ -168,6 +375,28 @@ private:
 	UPROPERTY()
 	int32 ArmorModuleSlotsUnlockedAfterUpgrade = 0;
 
+	// Делегаты по слотам (индекс = EEquipmentSlotId; None — заглушка)
+	TArray<FOnEquipmentSlotChangedNative> SlotChangedDelegates;
+
+	// Замки/блокировки битами слотов (динамика поверх статической маски предмета)
+	uint32 LockedSlotsMask = 0;
+	uint32 BlockedSlotsMask = 0;
+
+	// Снимок на входе во внешний батч (для вычисления FEquipmentChangeSet)
+	int32 ChangeBatchDepth = 0;
+	TArray<UItemObject*> BatchItemsBefore;
+	uint32 BatchLockedBefore = 0;
+	uint32 BatchBlockedBefore = 0;
+
+	// Вклад каждого слота в статы (по индексу слота; пустой/не-статовый слот — нули) и их сумма
+	TArray<FEquipmentStatVector> SlotStatTerms;
+	FEquipmentStatVector StatTotals;
+	bool bStatTermsDirty = false;
+
+	// Вклад каждого слота в SlotsHash (по индексу слота)
+	TArray<uint64> SlotHashTerms;
+	uint64 SlotsHash = 0;
+
 private:
 	int32 ToIndex(EEquipmentSlotId SlotId) const;
 	bool IsValidSlot(EEquipmentSlotId SlotId) const;
@@ -176,17 +405,33 @@ private:
 	bool RemoveFromInventoryIfPresent(UItemObject* Item) const;
 
 	static bool IsPrimarySecondaryWeaponSubCat(EItemSubCategory SubCat);
-	void BroadcastChanged(EEquipmentSlotId SlotId);
 
-	static bool HasAnyTag(const TArray<FName>& ItemTags, const TArray<FName>& QueryTags);
+	/** Разослать OnEquipmentSlotChanged по слотам набора и один OnEquipmentChanged. */
+	void BroadcastChangeSet(const FEquipmentChangeSet& ChangeSet);
+
+	void BroadcastStatsChanged();
+
+	/** Пересчитать вклад слота в SlotsHash (после смены предмета/замка/содержимого предмета). */
+	void UpdateSlotHash(int32 Index);
+
+	/** Инвентарь: у надетого предмета поменялось содержимое — обновить вклад его слота. */
+	void HandleEquippedItemContentChanged(const UItemObject* Item);
 
-	static bool IsAllowedByLists(
-		const UItemObject* Candidate,
-		const TArray<int32>& AllowedIDs,
-		const TArray<int32>& BlockedIDs,
-		const TArray<FName>& AllowedTags,
-		const TArray<FName>& BlockedTags
-	);
+	/** Перечитать вклад слота в статы (рядом с UpdateSlotHash). Сумма — в RecomputeStatTotals. */
+	void UpdateSlotStats(int32 Index);
+
+	/** Пересуммировать статы, отдать бонус переноса в инвентарь; true — сумма изменилась. */
+	bool RecomputeStatTotals();
+
+	/** Блокировки слотов при броне Armor с открытыми Unlocked из MaxSlots слотов артефактов (без записи в Blocked). */
+	uint32 ComputeBlockedSlotsMask(const UItemObject* Armor, int32 MaxSlots, int32 Unlocked) const;
+
+	/** Предмет для слота пресета: сам предмет (если он у нас), иначе такой же ассет из грида не из Taken. */
+	UItemObject* ResolveLoadoutItem(const FEquipmentLoadoutSlot& Entry, const TSet<const UItemObject*>& Taken) const;
+
+	/** Предметы слотов по индексу (для отката EquipToSlot). */
+	TArray<UItemObject*> CaptureSlotItems() const;
+	void RestoreSlotItems(const TArray<UItemObject*>& SlotItems);
 
 	bool IsHelmetCompatibleWithArmor(const UItemObject* Helmet, const UItemObject* Armor) const;
 	bool IsBackpackCompatibleWithArmor(const UItemObject* Backpack, const UItemObject* Armor) const;
@@ -194,3 +439,14 @@ private:
 	// читает OutfitStatsConfig брони и вызывает SetArmorModuleSlots(...)
 	void ApplyArmorModuleSlotsFromEquippedArmor();
 };
+
+/** Батч изменений экипировки на время скоупа (вложенные скоупы ничего не рассылают). */
+class UESTALKER_API FEquipmentChangeScope : public FNoncopyable
+{
+public:
+	explicit FEquipmentChangeScope(UEquipmentComponent* InEquipment);
+	~FEquipmentChangeScope();
+
+private:
+	UEquipmentComponent* Equipment = nullptr;
+};
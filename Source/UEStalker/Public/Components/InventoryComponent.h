@@ -3,13 +3,152 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Items/MasterItemStructs.h"
+#include "Components/InventoryItemIndex.h"
+#include "Components/InventoryItemTable.h"
+#include "Components/InventoryOccupancyGrid.h"
+#include "Components/InventoryPlacementMask.h"
+#include "Components/InventoryPlacementStrategy.h"
+#include "Components/InventoryStateHash.h"
+#include "Items/ItemObject.h"
 #include "InventoryComponent.generated.h"
 
 class UItemObject;
 class AMasterItemActor;
+class UMasterItemDataAsset;
+struct FInventorySortResult;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnInventoryChanged);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnItemUsed, UItemObject*, Item);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInventorySorted, bool, bApplied);
+
+// Нативные версии для C++ подписчиков (без ProcessEvent); динамические — для Blueprint
+DECLARE_MULTICAST_DELEGATE(FOnInventoryChangedNative);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnItemUsedNative, UItemObject*);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnInventorySortedNative, bool);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnEquippedItemContentChangedNative, const UItemObject*);
+
+/** Размещение предмета в гриде. Каноническая запись: клетки (Cells) строятся из нее. */
+USTRUCT(BlueprintType)
+struct FInventoryItemPlacement
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Inventory")
+	FTile TopLeftTile;
+
+	/** Размер с учетом поворота (в клетках) */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Inventory")
+	FIntPoint Size = FIntPoint(1, 1);
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Inventory")
+	bool bRotated = false;
+
+	FORCEINLINE FIntRect GetRect() const
+	{
+		return FIntRect(TopLeftTile.X, TopLeftTile.Y, TopLeftTile.X + Size.X, TopLeftTile.Y + Size.Y);
+	}
+};
+
+/** Предмет, который инвентарь хранит по значению (без UItemObject), и его место в гриде. */
+USTRUCT(BlueprintType)
+struct FInventoryStoredItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Inventory")
+	FItemInstance Instance;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Inventory")
+	FInventoryItemPlacement Placement;
+};
+
+/** Изменение одного предмета за кадр (старое/новое размещение + что поменялось). */
+USTRUCT(BlueprintType)
+struct FInventoryItemDelta
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	TObjectPtr<UItemObject> Item = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	bool bAdded = false;
+
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	bool bRemoved = false;
+
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	bool bMoved = false;
+
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	bool bRotated = false;
+
+	/** Стак / патроны / магазин / прочность */
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	bool bStateChanged = false;
+
+	/** Валидно, если предмет был в гриде в начале кадра */
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	bool bHadPlacement = false;
+
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	FInventoryItemPlacement OldPlacement;
+
+	/** Валидно, если предмет в гриде сейчас */
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	bool bHasPlacement = false;
+
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	FInventoryItemPlacement NewPlacement;
+};
+
+/** Все изменения инвентаря за кадр (одно событие на кадр). */
+USTRUCT(BlueprintType)
+struct FInventoryDelta
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	TArray<FInventoryItemDelta> Items;
+
+	/** Поменялся сам грид (SetGridSize) — слушателю проще перестроиться целиком */
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	bool bFullRefresh = false;
+
+	bool Contains(const UItemObject* Item) const
+	{
+		return Items.ContainsByPredicate([Item](const FInventoryItemDelta& Entry) { return Entry.Item == Item; });
+	}
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInventoryDelta, const FInventoryDelta&, Delta);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnInventoryDeltaNative, const FInventoryDelta&);
+
+/** Итог массового переноса (TransferItemsTo). */
+USTRUCT(BlueprintType)
+struct FInventoryTransferResult
+{
+	GENERATED_BODY()
+
+	/** Предметов перенесено целиком (легли в грид цели или полностью влились в ее стаки) */
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	int32 NumMoved = 0;
+
+	/** Единиц, влитых в стаки цели (включая частично перенесенные стаки) */
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	int32 NumMergedUnits = 0;
+
+	/** Остались в исходном инвентаре: не хватило места или веса (частично влитые — с уменьшенным стаком) */
+	UPROPERTY(BlueprintReadOnly, Category="Inventory")
+	TArray<TObjectPtr<UItemObject>> NotMoved;
+};
+
+/** Запись журнала транзакции: состояние и размещение предмета до первого изменения. */
+struct FInventoryTransactionEntry
+{
+	FItemObjectSnapshot State;
+	TOptional<FInventoryItemPlacement> Placement;
+};
 
 UCLASS(ClassGroup=(Inventory), meta=(BlueprintSpawnableComponent))
 class UESTALKER_API UInventoryComponent : public UActorComponent
@@ -27,9 +166,9 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Inventory", meta=(ClampMin="1", UIMin="1"))
 	int32 Rows;
 
-	// Слоты инвентаря (1D массив: Index = Y * Columns + X)
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Inventory")
-	TArray<TObjectPtr<UItemObject>> Items;
+	/** Как TryAddItem выбирает место (все стратегии пробуют и поворот, если bCanRotate) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Inventory")
+	EInventoryPlacementStrategy PlacementStrategy = EInventoryPlacementStrategy::FirstFit;
 
 	/** 0 = без лимита */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Inventory|Weight", meta=(ClampMin="0.0", UIMin="0.0"))
@@ -42,6 +181,23 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="Inventory|Events")
 	FOnItemUsed OnItemUsed;
 
+	/** Что именно поменялось за кадр (добавлено/убрано/сдвинуто/повернуто/стак-патроны). Приходит до OnInventoryChanged. */
+	UPROPERTY(BlueprintAssignable, Category="Inventory|Events")
+	FOnInventoryDelta OnInventoryDelta;
+
+	/** Фоновая сортировка завершилась (bApplied=false — места не нашлось или инвентарь успел измениться) */
+	UPROPERTY(BlueprintAssignable, Category="Inventory|Events")
+	FOnInventorySorted OnInventorySorted;
+
+	// ==== Native events (C++: AddUObject/RemoveAll). Приходят раньше Blueprint-версий ====
+	FOnInventoryChangedNative OnInventoryChangedNative;
+	FOnItemUsedNative OnItemUsedNative;
+	FOnInventoryDeltaNative OnInventoryDeltaNative;
+	FOnInventorySortedNative OnInventorySortedNative;
+
+	/** Содержимое надетого предмета поменялось (патроны в руках, стак, конфиги) — слот пересчитывает свой вклад в хэш. */
+	FOnEquippedItemContentChangedNative OnEquippedItemContentChangedNative;
+
 	// ==== Flags ====
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Inventory")
 	bool bIsInventoryChanged = false;
@@ -58,21 +214,48 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Inventory|Events")
 	void MarkItemUsed(UItemObject* Item);
 
+	/** Разослать накопленные события (OnInventoryDelta/OnInventoryChanged/OnItemUsed). Вызывает UInventoryNotifySubsystem в конце кадра. */
+	void FlushNotifications();
+
+	/** Поменялось состояние переносимого предмета в обход сеттеров (прочность/заряд) — попадет в OnInventoryDelta. */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Events")
+	void MarkItemStateChanged(UItemObject* Item);
+
 	UFUNCTION(BlueprintPure, Category="Inventory")
 	FORCEINLINE int32 GetCapacity() const { return Columns * Rows; }
 
 	// =========================================
-	// Weight cache API
+	// Weight ledger API
 	// =========================================
 
+	/**
+	 * Пересчитать журнал веса с нуля (страховка).
+	 * В норме вес ведется дельтами: стак, патроны в магазине, магазин в оружии, грид, экипировка.
+	 */
 	UFUNCTION(BlueprintCallable, Category="Inventory|Weight")
 	void InvalidateWeight();
 
 	UFUNCTION(BlueprintPure, Category="Inventory|Weight")
 	float GetTotalWeight() const;
 
+	/** Общий переносимый вес в граммах (точное значение журнала) */
+	FORCEINLINE int64 GetTotalWeightGrams() const { return TotalWeightGrams; }
+
+	/** кг -> целые граммы (журнал хранит целые, чтобы дельты не копили ошибку float) */
+	static FORCEINLINE int64 WeightToGrams(float Weight)
+	{
+		return FMath::RoundToInt64(static_cast<double>(FMath::Max(0.f, Weight)) * 1000.0);
+	}
+
+	/** Эффективный лимит: MaxCarryWeight + бонус экипировки (0 = без лимита) */
+	UFUNCTION(BlueprintPure, Category="Inventory|Weight")
+	FORCEINLINE float GetMaxCarryWeight() const { return MaxCarryWeight > 0.f ? MaxCarryWeight + CarryBonusWeight : 0.f; }
+
 	UFUNCTION(BlueprintPure, Category="Inventory|Weight")
-	FORCEINLINE float GetMaxCarryWeight() const { return MaxCarryWeight; }
+	FORCEINLINE float GetCarryBonusWeight() const { return CarryBonusWeight; }
+
+	/** Бонус к лимиту от надетого (рюкзак, броня, артефакты) — выставляет UEquipmentComponent. */
+	void SetCarryBonusWeight(float NewBonus);
 
 	/** Проверка перегруза по предмету (учитывает StackCount * ItemWeight) */
 	UFUNCTION(BlueprintPure, Category="Inventory|Weight")
@@ -82,6 +265,49 @@ public:
 	UFUNCTION(BlueprintPure, Category="Inventory|Weight")
 	bool CanTakeAdditionalWeight(float AddWeight) const;
 
+	bool CanTakeAdditionalWeightGrams(int64 AddGrams) const;
+
+	/** Вес предмета в граммах: стак + патроны в магазине + вставленный магазин */
+	int64 GetStackWeightGrams(const UItemObject* ItemObject) const;
+
+	/** Вызывается из UItemObject, когда у переносимого предмета (корня) поменялся вес. */
+	void NotifyItemWeightChanged(UItemObject* ItemObject);
+
+	/** Вызывается из UItemObject::PostConfigEdit: у переносимого предмета поменялись конфиги (стак, категория, вес). */
+	void NotifyItemConfigChanged(UItemObject* ItemObject);
+
+	/** Экипировка владельца: надетые предметы тоже несем (вес + OwningInventory). */
+	void SetItemEquipped(UItemObject* ItemObject, bool bEquipped);
+
+	// =========================================
+	// Content hash
+	// =========================================
+
+	/**
+	 * 64-битный хэш содержимого грида: размещения, стаки, магазины (и хранимые по значению).
+	 * Обновляется за O(1) на изменение; не меняется на no-op мутациях (в отличие от bIsInventoryChanged).
+	 * Равные хэши — можно пропустить обновление UI / сохранение / репликацию.
+	 */
+	FORCEINLINE uint64 GetContentHash() const { return ContentHash; }
+
+	UFUNCTION(BlueprintPure, Category="Inventory", meta=(DisplayName="Get Content Hash"))
+	int64 K2_GetContentHash() const { return static_cast<int64>(ContentHash); }
+
+	// =========================================
+	// Stack index
+	// =========================================
+
+	/**
+	 * Докинуть Count штук Asset в уже лежащие неполные стаки (по индексу, без обхода грида).
+	 * Exclude — объект, в который не докидываем (сам добавляемый предмет).
+	 * Возвращает, сколько штук легло в стаки.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Stack")
+	int32 AddToExistingStacks(UMasterItemDataAsset* Asset, int32 Count, const UItemObject* Exclude = nullptr);
+
+	/** Вызывается из UItemObject::SetStackCount для предметов, лежащих в этом инвентаре. */
+	void NotifyItemStackChanged(UItemObject* ItemObject);
+
 	// =========================================
 	// Requested functions
 	// =========================================
@@ -89,6 +315,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Inventory")
 	void SetGridSize(int32 NewColumns, int32 NewRows);
 
+	// Читатели ниже (GetItemAtIndex/GetAllItems/виды) видят только UItemObject грида: хранимые по значению
+	// предметы в них не попадают, пока их не материализуют явно (MaterializeItems при открытии UI, MaterializeItemAt).
+
+	/** Предмет в клетке Index (Index = Y * Columns + X); bValid — индекс в гриде. */
 	UFUNCTION(BlueprintCallable, Category="Inventory")
 	void GetItemAtIndex(int32 Index, bool& bValid, UItemObject*& ItemObject) const;
 
@@ -96,10 +326,38 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category="Inventory")
 	TArray<UItemObject*> GetAllItems() const;
 
-	/** Найти TopLeftIndex предмета (по первой найденной ячейке). INDEX_NONE если не найден. */
+	// ===== Views (вкладки/сортировки UI) =====
+
+	/** Предметы грида категории (без порядка) — из индекса, без прохода по всему гриду. */
+	UFUNCTION(BlueprintPure, Category="Inventory|Views")
+	TArray<UItemObject*> GetItemsByCategory(EItemCategory Category) const;
+
+	/** Предметы грида с ItemFilter == Filter; Filter_All — все предметы. */
+	UFUNCTION(BlueprintPure, Category="Inventory|Views")
+	TArray<UItemObject*> GetItemsByFilter(EItemFilter Filter) const;
+
+	/** Предметы в порядке SortKey. Category != ItemCat_None — только эта категория. */
+	UFUNCTION(BlueprintPure, Category="Inventory|Views")
+	TArray<UItemObject*> GetSortedItems(EInventorySortKey SortKey, bool bDescending = false, EItemCategory Category = EItemCategory::ItemCat_None) const;
+
+	/** Индексы предметов грида (категории/фильтры/сортированные виды). StoredItems в них не входят (без материализации). */
+	FORCEINLINE const FInventoryItemIndex& GetItemIndex() const { return ItemIndex; }
+
+	/** Найти TopLeftIndex предмета (из таблицы размещений). INDEX_NONE если не найден. */
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category="Inventory")
 	int32 FindTopLeftIndexForItem(const UItemObject* ItemObject) const;
 
+	/** Размещение предмета в гриде (TopLeft/Size/Rotation). false если предмета нет в гриде. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category="Inventory")
+	bool GetItemPlacement(const UItemObject* ItemObject, FInventoryItemPlacement& OutPlacement) const;
+
+	/** Предмет лежит в гриде. Хранимые по значению предметы — не UItemObject, ими ItemObject быть не может. */
+	UFUNCTION(BlueprintPure, Category="Inventory")
+	bool ContainsItem(const UItemObject* ItemObject) const;
+
+	/** Таблица размещений: предмет -> TopLeft/Size/Rotation */
+	FORCEINLINE const TMap<TObjectPtr<UItemObject>, FInventoryItemPlacement>& GetPlacements() const { return Placements; }
+
 	/** Index -> Tile (X,Y). Если Index вне диапазона - вернет X=-1,Y=-1 */
 	UFUNCTION(BlueprintPure, Category="Inventory")
 	FTile IndexToTile(int32 Index) const;
@@ -108,9 +366,12 @@ public:
 	UFUNCTION(BlueprintPure, Category="Inventory")
 	int32 TileToIndex(const FTile& Tile) const;
 
-	/** Записать ItemObject во все клетки, начиная с TopLeftIndex (учитывает поворот Runtime.bIsRotated). */
+	/**
+	 * Записать ItemObject во все клетки, начиная с TopLeftIndex (учитывает поворот Runtime.bIsRotated).
+	 * false — не лег: вне грида, место занято или кончилась таблица хэндлов.
+	 */
 	UFUNCTION(BlueprintCallable, Category="Inventory")
-	void AddItemAt(UItemObject* ItemObject, int32 TopLeftIndex);
+	bool AddItemAt(UItemObject* ItemObject, int32 TopLeftIndex);
 
 	/** Проверка: помещается ли предмет (с учетом размера/поворота) начиная с TopLeftIndex. */
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category="Inventory")
@@ -123,6 +384,12 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category="Inventory")
 	bool IsRoomAvailableForMove(UItemObject* ItemObject, int32 TopLeftIndex) const;
 
+	/**
+	 * Маска допустимых TopLeft под предмет в текущей ориентации (один раз на drag, дальше O(1) на клетку).
+	 * bIgnoreOwnCells — как IsRoomAvailableForMove: старые клетки предмета считаются свободными.
+	 */
+	void BuildPlacementMask(const UItemObject* ItemObject, bool bIgnoreOwnCells, FInventoryPlacementMask& OutMask) const;
+
 	// =========================================
 	// Weapon/Magazine/Ammo apply (Drag&Drop)
 	// =========================================
@@ -131,6 +398,13 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category="Inventory|Apply")
 	bool CanApplyItemToItem(const UItemObject* Payload, const UItemObject* Target) const;
 
+	/**
+	 * Все предметы грида и надетые предметы, на которые можно применить Payload — одним проходом
+	 * (подсветка целей в начале drag). StoredItems не входят: у них нет UItemObject.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Apply")
+	void GetAppliableTargets(const UItemObject* Payload, TArray<UItemObject*>& OutTargets) const;
+
 	/**
 	 * Apply Payload to Target.
 	 * RequestedCount: for Ammo->Mag (0 = fill to cap). Ignored for Mag->Weapon.
@@ -160,15 +434,101 @@ public:
 	UFUNCTION(BlueprintPure, Category="Inventory|Grid", meta=(DisplayName="For Each Index"))
 	void ForEachIndex(UItemObject* ItemObject, int32 TopLeftIndex, TArray<FTile>& OutTiles) const;
 
+	// =========================================
+	// Sort / compact
+	// =========================================
+
+	/**
+	 * Сортировка и уплотнение грида: по категориям, со сливанием неполных стаков и поворотом предметов.
+	 * Решение ищется в фоне по снимку (TimeBudgetSeconds на перебор), применяется одним изменением.
+	 * Если за время расчета инвентарь изменился — результат отбрасывается.
+	 * false — сортировка уже идет или грид пуст.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Sort")
+	bool RequestSort(float TimeBudgetSeconds = 0.05f);
+
+	UFUNCTION(BlueprintPure, Category="Inventory|Sort")
+	FORCEINLINE bool IsSortInProgress() const { return bSortInProgress; }
+
+	// =========================================
+	// Item instances (предметы по значению)
+	// =========================================
+
+	/**
+	 * Положить предмет, не создавая UItemObject: он хранится как FItemInstance и занимает клетки грида.
+	 * Если инвентарь сейчас кто-то слушает (открыт UI) или идет транзакция — кладется обычным UItemObject.
+	 * Все или ничего: false — ни одна единица стака не взята.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Instances")
+	bool TryAddItemInstance(const FItemInstance& Instance);
+
+	/** Создать UItemObject для всех хранимых по значению предметов (перед показом в UI / доступом из Blueprint). */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Instances")
+	void MaterializeItems();
+
+	/** Создать UItemObject только для хранимого предмета, занимающего клетку Index. nullptr — такого нет. */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Instances")
+	UItemObject* MaterializeItemAt(int32 Index);
+
+	/** Свернуть предметы грида в FItemInstance и отпустить их UItemObject (офлайн NPC, торговцы). Предметы с ConfigOverrides не сворачиваются. */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Instances")
+	void DehydrateItems();
+
+	UFUNCTION(BlueprintPure, Category="Inventory|Instances")
+	FORCEINLINE bool HasStoredItems() const { return StoredItems.Num() > 0; }
+
+	/** Вес FItemInstance в граммах (как GetStackWeightGrams, но по ассету). */
+	static int64 GetInstanceWeightGrams(const FItemInstance& Instance);
+
+	// =========================================
+	// Bulk transfer
+	// =========================================
+
+	/**
+	 * Перенести предметы этого инвентаря в Target одним действием (лут тела, выгрузка тайника).
+	 * Сначала план на копии занятости/веса цели: крупные вперед, стакуемые сперва вливаются в стаки,
+	 * потом применение в транзакциях обеих сторон — по одному уведомлению на сторону.
+	 * Предметы не из этого грида пропускаются.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Transfer")
+	FInventoryTransferResult TransferItemsTo(UInventoryComponent* Target, const TArray<UItemObject*>& Items);
+
+	/** Перенести всё содержимое грида (хранимые по значению предметы сперва материализуются). */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Transfer")
+	FInventoryTransferResult TransferAllTo(UInventoryComponent* Target);
+
+	// =========================================
+	// Transactions
+	// =========================================
+
+	/**
+	 * Начать транзакцию (вложенные допускаются).
+	 * До внешнего Commit уведомление OnInventoryChanged копится и уходит одно.
+	 * Транзакция живет в пределах одного вызова/кадра — не держать ее между кадрами.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Transaction")
+	void BeginTransaction();
+
+	/** Завершить транзакцию. Если внутри был Abort — внешний Commit откатывает всё. */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Transaction")
+	void CommitTransaction();
+
+	/** Откатить транзакцию: размещения, стаки и магазины затронутых предметов возвращаются. */
+	UFUNCTION(BlueprintCallable, Category="Inventory|Transaction")
+	void AbortTransaction();
+
+	UFUNCTION(BlueprintPure, Category="Inventory|Transaction")
+	FORCEINLINE bool IsInTransaction() const { return TransactionDepth > 0; }
+
+	/**
+	 * Запомнить предмет для отката (первое касание в транзакции).
+	 * Мутаторы инвентаря делают это сами; вне транзакции — ничего не делает.
+	 */
+	void RecordItemState(UItemObject* ItemObject);
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void OnRegister() override;
-
-	virtual void TickComponent(
-		float DeltaTime,
-		ELevelTick TickType,
-		FActorComponentTickFunction* ThisTickFunction
-	) override;
 	
 private:
 	FORCEINLINE bool IsTileInBounds(const FTile& Tile) const
@@ -178,10 +538,150 @@ private:
 
 	FORCEINLINE FIntPoint GetEffectiveItemSize(const UItemObject* ItemObject) const;
 
-	float GetStackWeight(const UItemObject* ItemObject) const;
-	bool AreStackCompatible(const UItemObject* A, const UItemObject* B) const;
+	/** Предмет лег в грид / ушел из грида / надет / снят: индексы, журнал веса и OwningInventory. */
+	void SyncItemIndices(UItemObject* ItemObject);
+
+	FORCEINLINE bool IsCarried(const UItemObject* ItemObject) const
+	{
+		return ContainsItem(ItemObject) || EquippedItems.Contains(const_cast<UItemObject*>(ItemObject));
+	}
+
+	/** Встать в очередь рассылки UInventoryNotifySubsystem (один раз до следующего Flush). */
+	void QueueNotify();
+
+	/** Запомнить предмет в дельте кадра (размещение — на момент первого касания). */
+	void NoteItemDelta(UItemObject* ItemObject, bool bStateChanged);
+
+	/** Собрать дельту кадра из PendingDeltas и текущих размещений. */
+	void BuildPendingDelta(FInventoryDelta& OutDelta);
+
+	/** Game thread: применить решение фоновой сортировки (если снимок еще актуален). */
+	void ApplySortResult(const FInventorySortResult& Result);
+
+	/** Вернуть журнал транзакции: стереть текущие футпринты, восстановить состояние и размещения. */
+	void RollbackTransaction();
+
+	/** Пересчитать запись журнала для предмета и применить дельту к TotalWeightGrams. */
+	void PostItemWeight(const UItemObject* ItemObject);
+
+	/** Держать предмет в OpenStacks ровно тогда, когда он в гриде и стак не полон. */
+	void UpdateOpenStack(UItemObject* ItemObject);
+
+	/** Держать предмет в ItemIndex ровно тогда, когда он в гриде (ключи — по текущему состоянию). */
+	void UpdateItemIndex(UItemObject* ItemObject);
+
+	/** Пересчитать вклад предмета в ContentHash (в гриде — с местом); надетый — сообщить слоту экипировки. */
+	void UpdateItemHash(const UItemObject* ItemObject);
+
+	/** XOR вклада хранимого предмета (добавить и убрать — одна и та же операция). */
+	FORCEINLINE void ToggleStoredItemHash(const FInventoryStoredItem& Stored)
+	{
+		ContentHash ^= FInventoryStateHash::HashPlaced(FInventoryStateHash::HashInstance(Stored.Instance), Stored.Placement.TopLeftTile.X, Stored.Placement.TopLeftTile.Y);
+	}
+
+	/**
+	 * Найти место под предмет по PlacementStrategy.
+	 * bOutRotated — класть повернутым относительно текущего Runtime.bIsRotated.
+	 */
+	bool FindFreeSpot(const UItemObject* ItemObject, int32& OutTopLeftIndex, bool& bOutRotated) const;
+
+	/** Пересобрать Cells, ItemTable и Occupancy из Placements (после ресайза/загрузки). */
+	void RebuildGridFromPlacements();
+
+	const FInventoryItemPlacement* FindPlacement(const UItemObject* ItemObject) const;
+
+	/** Записать/стереть предмет в клетках его прямоугольника (Cells + Occupancy); хэндл выдается/освобождается тут же. */
+	void WriteFootprint(const FInventoryItemPlacement& Placement, UItemObject* ItemObject);
+
+	/** Страховка размера массива клеток: выравнивает Cells под Columns*Rows и пересобирает Occupancy. */
+	void EnsureGridStorage();
+
+	// Каноническая таблица размещений (Cells/Occupancy — производные от нее).
+	// Единственная GC-ссылка на предмет грида.
+	UPROPERTY()
+	TMap<TObjectPtr<UItemObject>, FInventoryItemPlacement> Placements;
+
+	// Предметы по значению: без UItemObject, в Cells не пишутся, но занимают Occupancy
+	UPROPERTY()
+	TArray<FInventoryStoredItem> StoredItems;
+
+	/** Вынуть StoredItems[StoredIndex] и положить его UItemObject на то же место (или куда влезет). */
+	UItemObject* MaterializeStoredItem(int32 StoredIndex);
+
+	// Вес StoredItems (входит в TotalWeightGrams)
+	int64 StoredWeightGrams = 0;
+
+	// Клетки грида (Index = Y * Columns + X): 16-битный хэндл в ItemTable, 0 — пусто
+	TArray<uint16> Cells;
+
+	// Уникальные предметы грида по хэндлу (сырые указатели — держит Placements)
+	FInventoryItemTable ItemTable;
+
+	// Битовая карта занятости (синхронизируется в AddItemAt/RemoveItem/SetGridSize)
+	FInventoryOccupancyGrid Occupancy;
+
+	// Неполные стаки по SourceAsset (в нашем проекте самый безопасный ключ стака — SourceAsset).
+	// Объекты удерживает Placements, поэтому тут сырые указатели.
+	TMap<const UMasterItemDataAsset*, TArray<UItemObject*, TInlineAllocator<2>>> OpenStacks;
+
+	// Категории/фильтры/сортированные виды предметов грида (сырые указатели — держит Placements)
+	FInventoryItemIndex ItemIndex;
 	
-	// Weight cache
-	mutable bool bWeightDirty = true;
-	mutable float CachedTotalWeight = 0.f;
-};
\ No newline at end of file
+	// Надетые предметы (слоты держит UEquipmentComponent)
+	TSet<UItemObject*> EquippedItems;
+
+	// Журнал веса: переносимый предмет -> его вес в граммах
+	TMap<const UItemObject*, int64> WeightLedger;
+	int64 TotalWeightGrams = 0;
+
+	// Сумма CarryBonusWeight надетого (кэш UEquipmentComponent)
+	float CarryBonusWeight = 0.f;
+
+	// Хэш содержимого = XOR вкладов; вклад UItemObject запомнен, чтобы убрать его за O(1)
+	TMap<const UItemObject*, uint64> ItemHashTerms;
+	uint64 ContentHash = 0;
+
+	// Дельта кадра: предмет -> размещение в начале кадра + флаги
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UItemObject>, FInventoryItemDelta> PendingDeltas;
+
+	// Израсходованные UseItem предметы: в пул — только после рассылки их OnItemUsed/дельты
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UItemObject>> PendingReleases;
+
+	bool bPendingFullRefresh = false;
+
+	// Уже стоим в очереди рассылки на этот кадр
+	bool bNotifyQueued = false;
+
+	// Версия содержимого: растет на каждое изменение (проверка актуальности фоновой сортировки)
+	uint32 ContentVersion = 0;
+
+	// Sort: предметы снимка по индексу FInventorySortRequest::Items
+	bool bSortInProgress = false;
+	uint32 SortSnapshotVersion = 0;
+	TArray<TWeakObjectPtr<UItemObject>> SortSnapshotItems;
+
+	// Transactions (предметы удерживают Placements/слоты/вызывающий код — транзакция короче кадра)
+	int32 TransactionDepth = 0;
+	bool bTransactionAborted = false;
+	bool bTransactionChanged = false;
+	TMap<UItemObject*, FInventoryTransactionEntry> TransactionJournal;
+};
+
+/**
+ * Скоуп транзакции: Begin в конструкторе, Abort в деструкторе, если не было Commit().
+ * Ранний return из многошаговой операции сам откатывает изменения.
+ */
+class UESTALKER_API FInventoryTransactionScope : public FNoncopyable
+{
+public:
+	explicit FInventoryTransactionScope(UInventoryComponent* InInventory);
+	~FInventoryTransactionScope();
+
+	void Commit();
+
+private:
+	UInventoryComponent* Inventory = nullptr;
+	bool bFinished = false;
+};
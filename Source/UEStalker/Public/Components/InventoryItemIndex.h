@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Items/MasterItemEnums.h"
+#include "InventoryItemIndex.generated.h"
+
+class UItemObject;
+
+/** Ключ сортированного вида инвентаря (UI: "сортировать по ..."). */
+UENUM(BlueprintType)
+enum class EInventorySortKey : uint8
+{
+	/** Вес стака */
+	Weight  UMETA(DisplayName="Weight"),
+
+	/** Цена продажи стака */
+	Value   UMETA(DisplayName="Value"),
+
+	/** Площадь в клетках */
+	Size    UMETA(DisplayName="Size"),
+
+	/** ItemName (ключ локализации) */
+	Name    UMETA(DisplayName="Name"),
+};
+
+/**
+ * Индексы предметов грида для вкладок/сортировок UI: по категории, по фильтру
+ * и отсортированные виды по каждому EInventorySortKey (общие и по категории). Обновляются по одному предмету
+ * (Update/Remove), поэтому вкладка — O(предметов на вкладке), а не полный проход с сортировкой.
+ * Указатели сырые: предметы держит таблица размещений инвентаря.
+ */
+struct UESTALKER_API FInventoryItemIndex
+{
+public:
+	static constexpr int32 NumSortKeys = 4;
+
+	void Reset();
+
+	/** Добавить предмет или пересчитать его ключи (переставляет только если ключ изменился). */
+	void Update(UItemObject* Item, int64 WeightGrams);
+
+	void Remove(const UItemObject* Item);
+
+	FORCEINLINE bool Contains(const UItemObject* Item) const { return Keys.Contains(Item); }
+	FORCEINLINE int32 Num() const { return Keys.Num(); }
+
+	/** Предметы категории/фильтра (порядок не определен); nullptr — таких нет. */
+	const TArray<UItemObject*>* FindCategory(EItemCategory Category) const { return ByCategory.Find(Category); }
+	const TArray<UItemObject*>* FindFilter(EItemFilter Filter) const { return ByFilter.Find(Filter); }
+
+	/** Весь инвентарь в порядке SortKey. */
+	void GetSorted(EInventorySortKey SortKey, bool bDescending, TArray<UItemObject*>& OutItems) const;
+
+	/** Предметы категории в порядке SortKey (свой сортированный вид на категорию — без пересортировки). */
+	void GetSortedInCategory(EInventorySortKey SortKey, bool bDescending, EItemCategory Category, TArray<UItemObject*>& OutItems) const;
+
+private:
+	/** Запись сортированного вида: числовой ключ, затем имя, затем указатель (стабильный порядок). */
+	struct FEntry
+	{
+		int64 Key = 0;
+		FName Name;
+		UItemObject* Item = nullptr;
+	};
+
+	/** Ключи, с которыми предмет сейчас лежит в индексах (по ним же его и находим при удалении). */
+	struct FItemKeys
+	{
+		EItemCategory Category = EItemCategory::ItemCat_None;
+		EItemFilter Filter = EItemFilter::Filter_None;
+		int64 Sort[NumSortKeys] = {};
+		FName Name;
+	};
+
+	static bool EntryLess(const FEntry& A, const FEntry& B);
+	static FItemKeys MakeKeys(const UItemObject* Item, int64 WeightGrams);
+
+	FORCEINLINE static FEntry MakeEntry(const FItemKeys& ItemKeys, int32 SortIdx, const UItemObject* Item)
+	{
+		return { ItemKeys.Sort[SortIdx], ItemKeys.Name, const_cast<UItemObject*>(Item) };
+	}
+
+	/** Сортированные виды по каждому ключу (индекс — EInventorySortKey) */
+	struct FSortedViews
+	{
+		TArray<FEntry> Views[NumSortKeys];
+	};
+
+	static void InsertSorted(TArray<FEntry>& View, const FEntry& Entry);
+	static void RemoveSorted(TArray<FEntry>& View, const FEntry& Entry);
+
+	/** Вставить/убрать предмет во всех видах категории (пустая категория удаляется). */
+	void AddToCategoryViews(const FItemKeys& ItemKeys, const UItemObject* Item);
+	void RemoveFromCategoryViews(const FItemKeys& ItemKeys, const UItemObject* Item);
+
+	static void CopyView(const TArray<FEntry>& View, bool bDescending, TArray<UItemObject*>& OutItems);
+
+	TMap<const UItemObject*, FItemKeys> Keys;
+
+	TMap<EItemCategory, TArray<UItemObject*>> ByCategory;
+	TMap<EItemFilter, TArray<UItemObject*>> ByFilter;
+
+	// По возрастанию ключа, индекс — EInventorySortKey
+	TArray<FEntry> Sorted[NumSortKeys];
+
+	// То же по каждой категории (вкладки UI с сортировкой)
+	TMap<EItemCategory, FSortedViews> SortedByCategory;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UItemObject;
+
+/**
+ * Таблица уникальных предметов грида: клетки хранят 16-битный хэндл вместо указателя.
+ * Хэндл = [поколение 4 бита | слот+1 12 бит], 0 — пустая клетка.
+ * Поколение растет при освобождении слота, поэтому устаревший хэндл не резолвится в чужой предмет.
+ * Указатели сырые: GC-ссылку на предмет держит таблица размещений инвентаря.
+ */
+struct UESTALKER_API FInventoryItemTable
+{
+public:
+	static constexpr int32 IndexBits = 12;
+	static constexpr uint16 IndexMask = (1u << IndexBits) - 1u;
+	static constexpr uint16 GenerationMask = 0xF;
+
+	/** Слотов 4095: индекс 0 в хэндле занят под "пусто" */
+	static constexpr int32 MaxItems = IndexMask;
+
+	static constexpr uint16 InvalidHandle = 0;
+
+	void Reset();
+
+	/** Выдать хэндл под предмет. InvalidHandle — таблица заполнена. */
+	uint16 Acquire(UItemObject* Item);
+
+	/** Освободить слот хэндла (устаревший/чужой хэндл игнорируется). */
+	void Release(uint16 Handle);
+
+	/** Предмет по хэндлу; nullptr для пустого или устаревшего хэндла. */
+	UItemObject* Resolve(uint16 Handle) const;
+
+	bool IsValidHandle(uint16 Handle) const;
+
+	FORCEINLINE bool IsFull() const { return NumUsed >= MaxItems; }
+	FORCEINLINE int32 Num() const { return NumUsed; }
+
+private:
+	static FORCEINLINE int32 HandleSlot(uint16 Handle) { return static_cast<int32>(Handle & IndexMask) - 1; }
+	static FORCEINLINE uint8 HandleGeneration(uint16 Handle) { return static_cast<uint8>((Handle >> IndexBits) & GenerationMask); }
+
+	TArray<UItemObject*> Slots;
+	TArray<uint8> Generations;
+	TArray<uint16> FreeSlots;
+	int32 NumUsed = 0;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InventoryNotifySubsystem.generated.h"
+
+class UInventoryComponent;
+
+/**
+ * Отложенная рассылка событий инвентарей.
+ * Компоненты не тикают: при изменении встают в очередь, и в конце кадра
+ * каждый грязный инвентарь рассылает свои события один раз. Пустая очередь — нет тика.
+ */
+UCLASS()
+class UESTALKER_API UInventoryNotifySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Поставить инвентарь в очередь (повторы отсекает сам компонент). */
+	void QueueInventory(UInventoryComponent* Inventory);
+
+	/** Разослать все накопленное прямо сейчас. */
+	void FlushQueued();
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Queued.Num() > 0; }
+	virtual bool IsTickableWhenPaused() const override { return true; } // UI инвентаря открыт и на паузе
+	virtual TStatId GetStatId() const override;
+
+private:
+	TArray<TWeakObjectPtr<UInventoryComponent>> Queued;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Битовая карта занятости грида инвентаря (1 бит = 1 клетка).
+ * Строка хранится как WordsPerRow слов uint64 (64 колонки на слово, стэш любой ширины),
+ * поэтому проверка прямоугольника — несколько AND по маскам, а first-fit
+ * прыгает сразу к свободным участкам строки, а не перебирает каждую клетку.
+ */
+struct UESTALKER_API FInventoryOccupancyGrid
+{
+public:
+	void Init(int32 InColumns, int32 InRows);
+	void Reset();
+
+	FORCEINLINE int32 GetColumns() const { return Columns; }
+	FORCEINLINE int32 GetRows() const { return Rows; }
+
+	FORCEINLINE bool IsRectInBounds(int32 X, int32 Y, int32 W, int32 H) const
+	{
+		return W > 0 && H > 0 && X >= 0 && Y >= 0 && X + W <= Columns && Y + H <= Rows;
+	}
+
+	bool IsOccupied(int32 X, int32 Y) const;
+
+	/** Занять/освободить прямоугольник (часть за пределами грида отбрасывается). */
+	void SetRect(int32 X, int32 Y, int32 W, int32 H, bool bOccupied);
+
+	/** Прямоугольник целиком в гриде и все клетки свободны. */
+	bool IsRectFree(int32 X, int32 Y, int32 W, int32 H) const;
+
+	/** То же, но клетки Ignore считаются свободными (перемещение предмета поверх его старых клеток). */
+	bool IsRectFreeIgnoring(int32 X, int32 Y, int32 W, int32 H, const FIntRect& Ignore) const;
+
+	/**
+	 * Найти первый (row-major) TopLeft, куда помещается W x H.
+	 * false — места нет.
+	 */
+	bool FindFirstFree(int32 W, int32 H, int32& OutX, int32& OutY) const;
+
+	/** Позиция первого свободного бита >= FromX в строке-маске (Columns если нет). */
+	int32 FindNextFree(const uint64* RowWords, int32 FromX) const;
+
+	/** Позиция первого занятого бита >= FromX в строке-маске (Columns если нет). */
+	int32 FindNextOccupied(const uint64* RowWords, int32 FromX) const;
+
+	/** OR строк [Y, Y + H) в OutWords (WordsPerRow слов). */
+	void MergeRows(int32 Y, int32 H, uint64* OutWords) const;
+
+	FORCEINLINE int32 GetWordsPerRow() const { return WordsPerRow; }
+
+private:
+	FORCEINLINE const uint64* RowPtr(int32 Y) const { return Bits.GetData() + (Y * WordsPerRow); }
+	FORCEINLINE uint64* RowPtr(int32 Y) { return Bits.GetData() + (Y * WordsPerRow); }
+
+	/** Маска бит [From, To) внутри одного слова (0 <= From < To <= 64). */
+	static FORCEINLINE uint64 SpanMask(int32 From, int32 To)
+	{
+		const uint64 High = (To >= 64) ? ~0ull : ((1ull << To) - 1ull);
+		const uint64 Low  = (1ull << From) - 1ull;
+		return High & ~Low;
+	}
+
+	int32 FindNextBit(const uint64* RowWords, int32 FromX, bool bOccupied) const;
+
+	int32 Columns = 0;
+	int32 Rows = 0;
+	int32 WordsPerRow = 0;
+
+	TArray<uint64> Bits;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FInventoryOccupancyGrid;
+
+/**
+ * Маска допустимых TopLeft для предмета W x H (строится на время drag&drop).
+ * Один проход summed-area table по занятости — O(клеток); дальше "влезает ли сюда" — O(1),
+ * без обхода футпринта на каждое движение мыши / каждую перерисовку.
+ */
+struct UESTALKER_API FInventoryPlacementMask
+{
+public:
+	/** Ignore — клетки, которые считаются свободными (старое место перетаскиваемого предмета). */
+	void Build(const FInventoryOccupancyGrid& Grid, int32 InWidth, int32 InHeight, const FIntRect* Ignore = nullptr);
+	void Reset();
+
+	FORCEINLINE bool IsBuilt() const { return Columns > 0 && Rows > 0; }
+	FORCEINLINE bool IsBuiltFor(int32 InWidth, int32 InHeight) const { return IsBuilt() && Width == InWidth && Height == InHeight; }
+
+	FORCEINLINE bool IsValid(int32 X, int32 Y) const
+	{
+		return X >= 0 && Y >= 0 && X < Columns && Y < Rows && Valid[X + (Y * Columns)];
+	}
+
+	FORCEINLINE int32 NumValid() const { return ValidCount; }
+	FORCEINLINE int32 GetColumns() const { return Columns; }
+	FORCEINLINE int32 GetRows() const { return Rows; }
+
+	/**
+	 * Ближайший допустимый TopLeft к (X, Y) в пределах MaxDistance клеток (по Чебышеву).
+	 * false — поблизости места нет.
+	 */
+	bool FindNearestValid(int32 X, int32 Y, int32 MaxDistance, int32& OutX, int32& OutY) const;
+
+private:
+	int32 Columns = 0;
+	int32 Rows = 0;
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 ValidCount = 0;
+
+	TBitArray<> Valid;
+};
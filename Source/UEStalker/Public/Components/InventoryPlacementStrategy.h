@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryPlacementStrategy.generated.h"
+
+struct FInventoryOccupancyGrid;
+
+/**
+ * Стратегия выбора места для нового предмета (TryAddItem).
+ * Все стратегии пробуют обе ориентации, если у предмета bCanRotate.
+ */
+UENUM(BlueprintType)
+enum class EInventoryPlacementStrategy : uint8
+{
+	/** Первое место row-major; повернутый вариант — только если прямо не влезло */
+	FirstFit          UMETA(DisplayName="First Fit"),
+
+	/** Место с наименьшим нижним краем (Y + H), затем левее — грид заполняется сверху плотно */
+	BottomLeft        UMETA(DisplayName="Bottom-Left"),
+
+	/** Свободный участок с наименьшим остатком по короткой стороне (меньше обрезков) */
+	BestShortSideFit  UMETA(DisplayName="Best Short Side Fit"),
+
+	/** По "линии горизонта" колонок: ниже край, меньше дыр под предметом; дыры — через First Fit */
+	Skyline           UMETA(DisplayName="Skyline"),
+};
+
+struct UESTALKER_API FInventoryPlacementSolver
+{
+	/**
+	 * Найти место под предмет Size (в текущей ориентации) по стратегии.
+	 * bCanRotate — пробовать и Size.Y x Size.X; bOutRotated = выбран повернутый вариант.
+	 */
+	static bool FindPlacement(const FInventoryOccupancyGrid& Grid, EInventoryPlacementStrategy Strategy,
+		FIntPoint Size, bool bCanRotate, FIntPoint& OutTopLeft, bool& bOutRotated);
+};
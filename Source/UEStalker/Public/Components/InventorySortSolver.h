@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Предмет в снимке для сортировки (только данные — никаких UObject, снимок читается в фоне). */
+struct FInventorySortItem
+{
+	/** Размер без поворота */
+	FIntPoint Size = FIntPoint(1, 1);
+	bool bCanRotate = false;
+
+	uint8 Category = 0;
+	uint8 SubCategory = 0;
+	int32 ItemID = 0;
+
+	/** Группа стака (одинаковый SourceAsset), INDEX_NONE — не стакуется */
+	int32 StackGroup = INDEX_NONE;
+	int32 StackCount = 1;
+	int32 MaxStack = 1;
+};
+
+/** Неизменяемый снимок грида, который уходит в фоновый поток. */
+struct FInventorySortRequest
+{
+	int32 Columns = 0;
+	int32 Rows = 0;
+
+	TArray<FInventorySortItem> Items;
+
+	/** Бюджет на перебор вариантов (базовые варианты считаются всегда) */
+	double TimeBudgetSeconds = 0.05;
+	uint32 RandomSeed = 0;
+};
+
+struct FInventorySortPlacement
+{
+	int32 X = 0;
+	int32 Y = 0;
+	bool bRotated = false;
+};
+
+struct FInventorySortResult
+{
+	/** false — не удалось уложить все предметы, применять нечего */
+	bool bSuccess = false;
+
+	/** По индексу Request.Items. 0 — стак влит в другие и предмет удаляется */
+	TArray<int32> StackCounts;
+
+	/** По индексу Request.Items (для удаленных не используется) */
+	TArray<FInventorySortPlacement> Placements;
+
+	/** Пустые клетки в занятых строках (меньше — плотнее) */
+	int32 WastedCells = 0;
+
+	int32 Iterations = 0;
+};
+
+/**
+ * Сортировка/уплотнение грида: сливает неполные стаки, раскладывает по категориям,
+ * крутит предметы (bCanRotate) ради плотности. Чистая функция над снимком — безопасна в фоне.
+ * Перебирает порядок/ориентации, пока есть бюджет, и возвращает лучший найденный вариант.
+ */
+struct UESTALKER_API FInventorySortSolver
+{
+	static FInventorySortResult Solve(const FInventorySortRequest& Request);
+};
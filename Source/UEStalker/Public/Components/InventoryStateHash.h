@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UItemObject;
+class UMasterItemDataAsset;
+struct FItemInstance;
+struct FItemMagazineInstance;
+
+/**
+ * Вклады в 64-битный хэш содержимого (Zobrist-style): хэш инвентаря/экипировки — XOR вкладов
+ * всех предметов, поэтому изменение одного предмета — O(1): XOR старого вклада, XOR нового.
+ * Вклад зависит только от содержимого (ассет, стак, прочность, магазин), не от адресов объектов:
+ * предмет по значению (FItemInstance) и его UItemObject дают один и тот же вклад, а ассет входит
+ * стабильным ключом (UMasterItemDataAsset::GetStableHash) — хэш можно сохранять и сравнивать между машинами.
+ */
+struct UESTALKER_API FInventoryStateHash
+{
+	/** splitmix64: равномерно размазывает ключ по 64 битам */
+	static FORCEINLINE uint64 Mix(uint64 Value)
+	{
+		Value += 0x9E3779B97F4A7C15ull;
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	static FORCEINLINE uint64 Combine(uint64 Hash, uint64 Value)
+	{
+		return Mix(Hash ^ Value);
+	}
+
+	/** Стабильный ключ ассета (0 для nullptr). */
+	static uint64 HashAsset(const UMasterItemDataAsset* Asset);
+
+	/** Содержимое предмета (со вставленным магазином). 0 для nullptr. */
+	static uint64 HashItem(const UItemObject* Item);
+	static uint64 HashInstance(const FItemInstance& Instance);
+
+	/** Вклад предмета, лежащего в клетке TopLeft (поворот уже в содержимом). */
+	static FORCEINLINE uint64 HashPlaced(uint64 ItemHash, int32 X, int32 Y)
+	{
+		return Combine(Combine(ItemHash, static_cast<uint32>(X)), static_cast<uint64>(static_cast<uint32>(Y)) << 32);
+	}
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Items/MasterItemStructs.h"
+#include "ItemInstance.generated.h"
+
+class UMasterItemDataAsset;
+
+/** Магазин, вставленный в оружие (по значению, без UItemObject). */
+USTRUCT(BlueprintType)
+struct FItemMagazineInstance
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Item")
+	TObjectPtr<UMasterItemDataAsset> SourceAsset = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Runtime")
+	FItemRuntimeState Runtime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Runtime|Magazine")
+	int32 CurrentAmmo = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Runtime|Magazine")
+	EAmmoType LoadedAmmoType = EAmmoType::AmmoType_None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Runtime|Magazine")
+	float AmmoUnitWeight = 0.f;
+};
+
+/**
+ * Предмет по значению: ссылка на ассет + runtime-состояние.
+ * Конфиги не копируются (читаются из ассета), GC его не видит —
+ * UItemObject создается из него только когда предмет нужен UI/Blueprint.
+ */
+USTRUCT(BlueprintType)
+struct FItemInstance
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Item")
+	TObjectPtr<UMasterItemDataAsset> SourceAsset = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Runtime")
+	FItemRuntimeState Runtime;
+
+	/** For magazines: патроны, тип, вес единицы */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Runtime|Magazine")
+	int32 MagazineCurrentAmmo = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Runtime|Magazine")
+	EAmmoType MagazineLoadedAmmoType = EAmmoType::AmmoType_None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Runtime|Magazine")
+	float MagazineAmmoUnitWeight = 0.f;
+
+	/** For weapons: есть ли вставленный магазин (InsertedMagazine валиден только тогда) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Runtime|Weapon")
+	bool bHasInsertedMagazine = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Runtime|Weapon", meta=(EditCondition="bHasInsertedMagazine"))
+	FItemMagazineInstance InsertedMagazine;
+};
@@ -3,47 +3,90 @@
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
 #include "Items/MasterItemStructs.h"
+#include "Items/ItemInstance.h"
 #include "ItemObject.generated.h"
 
 class UMasterItemDataAsset;
+class UInventoryComponent;
 class USoundBase;
+struct FItemTagBits;
+struct FCompiledItemFilter;
+
+/** Снимок runtime-состояния предмета (откат транзакций инвентаря). */
+struct FItemObjectSnapshot
+{
+	FItemRuntimeState Runtime;
+	TWeakObjectPtr<UItemObject> InsertedMagazine;
+	int32 MagazineCurrentAmmo = 0;
+	EAmmoType MagazineLoadedAmmoType = EAmmoType::AmmoType_None;
+	float MagazineAmmoUnitWeight = 0.f;
+};
+
+/** Какие конфиги предмета переопределены у конкретного экземпляра. */
+enum class EItemConfigOverride : uint8
+{
+	None              = 0,
+	ItemDetails       = 1 << 0,
+	TradeConfig       = 1 << 1,
+	DurabilityConfig  = 1 << 2,
+	ChargeConfig      = 1 << 3,
+	OutfitStatsConfig = 1 << 4,
+	WeaponStatsConfig = 1 << 5,
+	MagazineConfig    = 1 << 6,
+	ConsumablesStats  = 1 << 7,
+};
+ENUM_CLASS_FLAGS(EItemConfigOverride);
 
 /**
- * Runtime-экземпляр предмета (в инвентаре).
- * Тут CurrDurability/CurrCharge/Stack/Rotation и т.п.
+ * Переопределенные конфиги одного предмета (апгрейды и т.п.).
+ * Создается только при первой записи (Edit*) — валидны лишь поля из OverrideMask.
  */
-UCLASS(BlueprintType)
-class UItemObject : public UObject
+UCLASS()
+class UItemConfigOverrides : public UObject
 {
 	GENERATED_BODY()
 
 public:
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Item")
-	TObjectPtr<UMasterItemDataAsset> SourceAsset = nullptr;
+	EItemConfigOverride OverrideMask = EItemConfigOverride::None;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Item")
+	UPROPERTY()
 	FMasterItemDetails ItemDetails;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Item")
+	UPROPERTY()
 	FItemTradeConfig TradeConfig;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Item")
+	UPROPERTY()
 	FItemDurabilityConfig DurabilityConfig;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Item")
+	UPROPERTY()
 	FItemChargeConfig ChargeConfig;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Item")
+	UPROPERTY()
 	FItemOutfitStatsConfig OutfitStatsConfig;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Item")
+	UPROPERTY()
 	FItemWeaponsStatsConfig WeaponStatsConfig;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Item")
+	UPROPERTY()
 	FItemMagazineConfig MagazineConfig;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Item")
+	UPROPERTY()
 	FConsumablesStats ConsumablesStats;
+};
+
+/**
+ * Runtime-экземпляр предмета (в инвентаре).
+ * Тут CurrDurability/CurrCharge/Stack/Rotation и т.п.
+ * Конфиги не копируются: Get*() читает их из SourceAsset (или из ConfigOverrides после Edit*()).
+ */
+UCLASS(BlueprintType)
+class UItemObject : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Item")
+	TObjectPtr<UMasterItemDataAsset> SourceAsset = nullptr;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Runtime")
 	FItemRuntimeState Runtime;
@@ -68,7 +111,64 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Runtime|Magazine")
 	float MagazineAmmoUnitWeight = 0.f;
 
+	/** Инвентарь, который несет предмет: лежит в гриде или надет (ставит/сбрасывает UInventoryComponent). */
+	UPROPERTY(Transient)
+	TWeakObjectPtr<UInventoryComponent> OwningInventory;
+
+	/** For magazines: weapon this magazine is inserted into (вес магазина учитывается в оружии). */
+	UPROPERTY(Transient)
+	TWeakObjectPtr<UItemObject> ParentItem;
+
 public:
+	// ===== Configs (read-only view into SourceAsset) =====
+	const FMasterItemDetails& GetItemDetails() const;
+	const FItemTradeConfig& GetTradeConfig() const;
+	const FItemDurabilityConfig& GetDurabilityConfig() const;
+	const FItemChargeConfig& GetChargeConfig() const;
+	const FItemOutfitStatsConfig& GetOutfitStatsConfig() const;
+	const FItemWeaponsStatsConfig& GetWeaponStatsConfig() const;
+	const FItemMagazineConfig& GetMagazineConfig() const;
+	const FConsumablesStats& GetConsumablesStats() const;
+
+	// ===== Configs (copy-on-write: первая запись копирует конфиг из ассета только этому предмету) =====
+	FMasterItemDetails& EditItemDetails();
+	FItemTradeConfig& EditTradeConfig();
+	FItemDurabilityConfig& EditDurabilityConfig();
+	FItemChargeConfig& EditChargeConfig();
+	FItemOutfitStatsConfig& EditOutfitStatsConfig();
+	FItemWeaponsStatsConfig& EditWeaponStatsConfig();
+	FItemMagazineConfig& EditMagazineConfig();
+	FConsumablesStats& EditConsumablesStats();
+
+	/** Закончили править Edit*() — сообщить инвентарю (индексы/вес/хэш) и экипировке (статы слота). */
+	UFUNCTION(BlueprintCallable, Category="Item")
+	void PostConfigEdit();
+
+	/** Есть ли у предмета собственные (переопределенные) конфиги */
+	FORCEINLINE bool HasConfigOverrides() const { return ConfigOverrides != nullptr; }
+
+	// Blueprint: копии конфигов (в C++ — Get*() по ссылке)
+	UFUNCTION(BlueprintPure, Category="Item", meta=(DisplayName="Get Item Details"))
+	FMasterItemDetails K2_GetItemDetails() const { return GetItemDetails(); }
+
+	UFUNCTION(BlueprintPure, Category="Item", meta=(DisplayName="Get Trade Config"))
+	FItemTradeConfig K2_GetTradeConfig() const { return GetTradeConfig(); }
+
+	UFUNCTION(BlueprintPure, Category="Item", meta=(DisplayName="Get Durability Config"))
+	FItemDurabilityConfig K2_GetDurabilityConfig() const { return GetDurabilityConfig(); }
+
+	UFUNCTION(BlueprintPure, Category="Item", meta=(DisplayName="Get Charge Config"))
+	FItemChargeConfig K2_GetChargeConfig() const { return GetChargeConfig(); }
+
+	UFUNCTION(BlueprintPure, Category="Item", meta=(DisplayName="Get Weapon Stats Config"))
+	FItemWeaponsStatsConfig K2_GetWeaponStatsConfig() const { return GetWeaponStatsConfig(); }
+
+	UFUNCTION(BlueprintPure, Category="Item", meta=(DisplayName="Get Magazine Config"))
+	FItemMagazineConfig K2_GetMagazineConfig() const { return GetMagazineConfig(); }
+
+	UFUNCTION(BlueprintPure, Category="Item", meta=(DisplayName="Get Consumables Stats"))
+	FConsumablesStats K2_GetConsumablesStats() const { return GetConsumablesStats(); }
+
 	UFUNCTION(BlueprintCallable, Category="Item")
 	void InitializeFromAsset(UMasterItemDataAsset* InAsset, int32 InStackCount = 1);
 
@@ -76,36 +176,36 @@ public:
 	void SetStackCount(int32 NewCount);
 
 	UFUNCTION(BlueprintPure, Category="Item")
-	bool IsStackable() const { return ItemDetails.bIsStackable; }
+	bool IsStackable() const { return GetItemDetails().bIsStackable; }
 
 	UFUNCTION(BlueprintPure, Category="Item")
-	bool IsWeapon() const { return ItemDetails.ItemCategory == EItemCategory::ItemCat_Weapons; }
+	bool IsWeapon() const { return GetItemDetails().ItemCategory == EItemCategory::ItemCat_Weapons; }
 
 	UFUNCTION(BlueprintPure, Category="Item")
-	bool IsAmmo() const { return ItemDetails.ItemCategory == EItemCategory::ItemCat_Ammo; }
+	bool IsAmmo() const { return GetItemDetails().ItemCategory == EItemCategory::ItemCat_Ammo; }
 
 	UFUNCTION(BlueprintPure, Category="Item")
-	bool IsMagazine() const { return ItemDetails.ItemSubCategory == EItemSubCategory::ItemSubCat_Attachments_Magazine || ItemDetails.MagazineType != EMagazineType::Mag_None; }
+	bool IsMagazine() const { return GetItemDetails().ItemSubCategory == EItemSubCategory::ItemSubCat_Attachments_Magazine || GetItemDetails().MagazineType != EMagazineType::Mag_None; }
 
 	// ===== Weapon runtime =====
 	UFUNCTION(BlueprintPure, Category="Item|Weapon")
 	UItemObject* GetInsertedMagazine() const { return InsertedMagazine; }
 
 	UFUNCTION(BlueprintCallable, Category="Item|Weapon")
-	void SetInsertedMagazine(UItemObject* NewMag) { InsertedMagazine = NewMag; }
+	void SetInsertedMagazine(UItemObject* NewMag);
 
 	UFUNCTION(BlueprintPure, Category="Item|Weapon")
 	bool IsMagazineCompatibleForWeapon(const UItemObject* MagItem) const;
 
 	// ===== Magazine runtime =====
 	UFUNCTION(BlueprintPure, Category="Item|Magazine")
-	int32 GetMagazineCapacity() const { return FMath::Max(0, MagazineConfig.Capacity); }
+	int32 GetMagazineCapacity() const { return FMath::Max(0, GetMagazineConfig().Capacity); }
 
 	UFUNCTION(BlueprintPure, Category="Item|Magazine")
 	int32 GetMagazineCurrentAmmo() const { return FMath::Max(0, MagazineCurrentAmmo); }
 
 	UFUNCTION(BlueprintCallable, Category="Item|Magazine")
-	void SetMagazineCurrentAmmo(int32 NewValue) { MagazineCurrentAmmo = FMath::Max(0, NewValue); }
+	void SetMagazineCurrentAmmo(int32 NewValue);
 
 	UFUNCTION(BlueprintPure, Category="Item|Magazine")
 	EAmmoType GetMagazineLoadedAmmoType() const { return MagazineLoadedAmmoType; }
@@ -117,13 +217,32 @@ public:
 	float GetMagazineAmmoUnitWeight() const { return MagazineAmmoUnitWeight; }
 
 	UFUNCTION(BlueprintCallable, Category="Item|Magazine")
-	void SetMagazineAmmoUnitWeight(float NewValue) { MagazineAmmoUnitWeight = FMath::Max(0.f, NewValue); }
+	void SetMagazineAmmoUnitWeight(float NewValue);
 
 	UFUNCTION(BlueprintPure, Category="Item|Magazine")
 	bool IsAmmoCompatibleForMagazine(EAmmoType AmmoType) const;
 
+	/** Тип магазина (ItemDetails, иначе MagazineConfig). */
+	EMagazineType GetMagazineType() const;
+
+	/** Совместимые патроны магазина битами EAmmoType (из ассета; с override конфига — из своей копии). */
+	uint64 GetCompatibleAmmoMask() const;
+
+	/** Совместимые магазины оружия битами EMagazineType (0 — список пуст). */
+	uint64 GetCompatibleMagazineMask() const;
+
+	/** Слоты экипировки, принимающие предмет по категории (без замков/брони — см. UEquipmentComponent). */
+	uint32 GetEquipSlotMask() const;
+
+	/** ItemTags битами реестра. Scratch заполняется только для предмета со своей копией ItemDetails. */
+	const FItemTagBits& GetItemTagBits(FItemTagBits& Scratch) const;
+
+	/** Скомпилированные списки брони (шлем/рюкзак). Scratch — для предмета со своей копией OutfitStatsConfig. */
+	const FCompiledItemFilter& GetHelmetFilter(FCompiledItemFilter& Scratch) const;
+	const FCompiledItemFilter& GetBackpackFilter(FCompiledItemFilter& Scratch) const;
+
 	UFUNCTION(BlueprintPure, Category="Item")
-	int32 GetMaxStack() const { return ItemDetails.bIsStackable ? ItemDetails.MaxStackCount : 1; }
+	int32 GetMaxStack() const { return GetItemDetails().bIsStackable ? GetItemDetails().MaxStackCount : 1; }
 
 	UFUNCTION(BlueprintPure, Category="Item", meta=(DisplayName="Get Sound Of Use"))
 	USoundBase* GetSoundOfUse() const;
@@ -140,6 +259,37 @@ public:
 	UFUNCTION(BlueprintPure, Category="Item", meta=(DisplayName="Get Pickup Sound"))
 	USoundBase* GetPickupSound() const;
 
+	/** Blueprint-копия; в C++ — GetOutfitStatsConfig() по ссылке */
 	UFUNCTION(BlueprintPure, Category="Item", meta=(DisplayName="Get Outfit Stats"))
-	FItemOutfitStatsConfig GetOutfitStats() const;
+	FItemOutfitStatsConfig GetOutfitStats() const { return GetOutfitStatsConfig(); }
+
+	/** Свернуть предмет в FItemInstance (вместе со вставленным магазином). */
+	UFUNCTION(BlueprintPure, Category="Item")
+	FItemInstance MakeInstance() const;
+
+	/** Новый предмет ассета по значению — то же состояние, что дает InitializeFromAsset. */
+	static FItemInstance MakeAssetInstance(UMasterItemDataAsset* InAsset, int32 InStackCount);
+
+	/** Инициализация из FItemInstance: конфиги из ассета, runtime/магазины из инстанса. */
+	UFUNCTION(BlueprintCallable, Category="Item")
+	void InitializeFromInstance(const FItemInstance& Instance);
+
+	FItemObjectSnapshot MakeSnapshot() const;
+
+	/** Вернуть состояние из снимка (через сеттеры: индексы/вес инвентаря обновятся). */
+	void RestoreSnapshot(const FItemObjectSnapshot& Snapshot);
+
+private:
+	/** Свои копии конфигов (nullptr — все читается из SourceAsset) */
+	UPROPERTY()
+	TObjectPtr<UItemConfigOverrides> ConfigOverrides = nullptr;
+
+	template <typename TConfig>
+	const TConfig& ResolveConfig(EItemConfigOverride Flag, TConfig UMasterItemDataAsset::* AssetMember, TConfig UItemConfigOverrides::* OverrideMember) const;
+
+	template <typename TConfig>
+	TConfig& EditConfig(EItemConfigOverride Flag, TConfig UMasterItemDataAsset::* AssetMember, TConfig UItemConfigOverrides::* OverrideMember);
+
+	/** Сообщить инвентарю-носителю, что вес поменялся (поднимаемся от магазина к оружию). */
+	void NotifyWeightChanged();
 };
\ No newline at end of file
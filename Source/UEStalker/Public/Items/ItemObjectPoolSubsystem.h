@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemObjectPoolSubsystem.generated.h"
+
+class UItemObject;
+class UMasterItemDataAsset;
+struct FItemInstance;
+
+/** Счетчики пула (с начала мира). */
+USTRUCT(BlueprintType)
+struct FItemObjectPoolStats
+{
+	GENERATED_BODY()
+
+	/** Выдан объект из пула */
+	UPROPERTY(BlueprintReadOnly, Category="Item|Pool")
+	int32 Hits = 0;
+
+	/** Пул пуст — пришлось NewObject */
+	UPROPERTY(BlueprintReadOnly, Category="Item|Pool")
+	int32 Misses = 0;
+
+	/** Возвращено в пул */
+	UPROPERTY(BlueprintReadOnly, Category="Item|Pool")
+	int32 Released = 0;
+
+	/** Не принято: пул полон / предмет еще в инвентаре / уже в пуле / есть ConfigOverrides */
+	UPROPERTY(BlueprintReadOnly, Category="Item|Pool")
+	int32 Rejected = 0;
+
+	/** Сейчас лежит в пуле */
+	UPROPERTY(BlueprintReadOnly, Category="Item|Pool")
+	int32 Pooled = 0;
+};
+
+/**
+ * Пул UItemObject на мир: израсходованные/уничтоженные предметы возвращаются сюда,
+ * новые выдаются через InitializeFromAsset вместо NewObject — меньше мусора для GC.
+ * Возвращенный предмет выдается только через кадр: отложенные события
+ * (OnItemUsed, дельта инвентаря) до рассылки еще видят его прежнее состояние.
+ * Release — только для объектов, на которые больше никто не ссылается.
+ * Размер — MaxPooled в DefaultGame.ini, секция [/Script/UEStalker.ItemObjectPoolSubsystem].
+ */
+UCLASS(Config=Game)
+class UESTALKER_API UItemObjectPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Предмет из пула мира WorldContext (без мира — обычный NewObject). */
+	static UItemObject* AcquireItem(const UObject* WorldContext, UMasterItemDataAsset* Asset, int32 StackCount = 1);
+
+	/** То же, но состояние берется из FItemInstance (вместе со вставленным магазином). */
+	static UItemObject* AcquireItem(const UObject* WorldContext, const FItemInstance& Instance);
+
+	/** Вернуть предмет в пул мира WorldContext (без мира — ничего, объект соберет GC). */
+	static void ReleaseItem(const UObject* WorldContext, UItemObject* Item);
+
+	UItemObject* Acquire(UMasterItemDataAsset* Asset, int32 StackCount = 1);
+
+	/** Вставленный магазин возвращается вместе с оружием. */
+	void Release(UItemObject* Item);
+
+	UFUNCTION(BlueprintPure, Category="Item|Pool")
+	FItemObjectPoolStats GetStats() const;
+
+	/** Сколько свободных объектов держать максимум (лишние отдаются GC) */
+	UPROPERTY(Config)
+	int32 MaxPooled = 512;
+
+	virtual void Deinitialize() override;
+
+private:
+	/** Перевести отлежавшие карантин объекты в свободные. */
+	void PromotePending();
+
+	/** Сколько кадров возвращенный объект не выдается */
+	static constexpr uint64 QuarantineFrames = 2;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UItemObject>> FreeItems;
+
+	// Карантин: в порядке возврата, PendingFrames[i] — кадр возврата PendingItems[i]
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UItemObject>> PendingItems;
+
+	TArray<uint64> PendingFrames;
+
+	FItemObjectPoolStats Stats;
+};
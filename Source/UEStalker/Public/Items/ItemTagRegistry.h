@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Общий на проект реестр тэгов предметов (ItemTags и тэги из allow/block-списков).
+ * Каждое FName получает номер бита — наборы тэгов сравниваются AND'ом слов, а не FName.
+ * Номера раздаются в порядке первой встречи, поэтому стабильны только внутри процесса:
+ * биты нельзя сохранять, реплицировать или сравнивать между запусками. Только растет.
+ */
+struct UESTALKER_API FItemTagRegistry
+{
+	/** Номер бита тэга (регистрирует новый). */
+	static int32 Intern(FName Tag);
+
+	static int32 Num();
+};
+
+/** Набор тэгов битами FItemTagRegistry. */
+struct UESTALKER_API FItemTagBits
+{
+public:
+	static FItemTagBits FromTags(const TArray<FName>& Tags);
+
+	void Add(int32 Bit);
+
+	FORCEINLINE bool IsEmpty() const { return Words.Num() == 0; }
+
+	/** Есть общий тэг */
+	FORCEINLINE bool Intersects(const FItemTagBits& Other) const
+	{
+		const int32 Count = FMath::Min(Words.Num(), Other.Words.Num());
+		for (int32 i = 0; i < Count; ++i)
+		{
+			if (Words[i] & Other.Words[i])
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	TArray<uint64, TInlineAllocator<2>> Words;
+};
+
+/**
+ * Скомпилированные allow/block-списки (броня -> шлем/рюкзак):
+ * ID — отсортированные массивы (бинарный поиск), тэги — FItemTagBits.
+ */
+struct UESTALKER_API FCompiledItemFilter
+{
+public:
+	void Compile(const TArray<int32>& InAllowedIDs, const TArray<int32>& InBlockedIDs,
+		const TArray<FName>& InAllowedTags, const TArray<FName>& InBlockedTags);
+
+	/** Та же логика, что списки в FItemOutfitStatsConfig: блок важнее, непустой allow-список надо пройти. */
+	bool Allows(int32 ItemID, const FItemTagBits& ItemTags) const;
+
+private:
+	TArray<int32> AllowedIDs;
+	TArray<int32> BlockedIDs;
+
+	FItemTagBits AllowedTags;
+	FItemTagBits BlockedTags;
+
+	bool bHasAllowedTags = false;
+};
@@ -4,6 +4,7 @@
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
 #include "Items/MasterItemStructs.h"
+#include "Items/ItemTagRegistry.h"
 #include "MasterItemDataAsset.generated.h"
 
 /**
@@ -46,4 +47,74 @@ public:
 		// Type = "MasterItem", Name = AssetName
 		return FPrimaryAssetId(TEXT("MasterItem"), GetFName());
 	}
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	// ===== Compatibility (битовые маски вместо Contains по спискам) =====
+
+	static FORCEINLINE uint64 AmmoTypeBit(EAmmoType Type)
+	{
+		const uint8 Value = static_cast<uint8>(Type);
+		return Value < 64 ? (1ull << Value) : 0ull;
+	}
+
+	static FORCEINLINE uint64 MagazineTypeBit(EMagazineType Type)
+	{
+		const uint8 Value = static_cast<uint8>(Type);
+		return Value < 64 ? (1ull << Value) : 0ull;
+	}
+
+	static uint64 BuildAmmoMask(const TArray<EAmmoType>& Types);
+	static uint64 BuildMagazineMask(const TArray<EMagazineType>& Types);
+
+	static void CompileHelmetFilter(const FItemOutfitStatsConfig& Config, FCompiledItemFilter& OutFilter);
+	static void CompileBackpackFilter(const FItemOutfitStatsConfig& Config, FCompiledItemFilter& OutFilter);
+
+	/** MagazineConfig.CompatibleAmmoTypes битами EAmmoType */
+	FORCEINLINE uint64 GetCompatibleAmmoMask() const { EnsureCompatibilityMasks(); return CompatibleAmmoMask; }
+
+	/** WeaponStatsConfig.CompatibleMagazines битами EMagazineType (0 — список пуст) */
+	FORCEINLINE uint64 GetCompatibleMagazineMask() const { EnsureCompatibilityMasks(); return CompatibleMagazineMask; }
+
+	/** Слоты экипировки по категории/подкатегории (UEquipmentComponent::SlotBit) */
+	FORCEINLINE uint32 GetEquipSlotMask() const { EnsureCompatibilityMasks(); return EquipSlotMask; }
+
+	/** ItemTags битами FItemTagRegistry */
+	FORCEINLINE const FItemTagBits& GetItemTagBits() const { EnsureCompatibilityMasks(); return ItemTagBits; }
+
+	/** Скомпилированные allow/block-списки брони для шлема / рюкзака */
+	FORCEINLINE const FCompiledItemFilter& GetHelmetFilter() const { EnsureCompatibilityMasks(); return HelmetFilter; }
+	FORCEINLINE const FCompiledItemFilter& GetBackpackFilter() const { EnsureCompatibilityMasks(); return BackpackFilter; }
+
+	/**
+	 * Ключ ассета для хэшей содержимого: PrimaryAssetId (строкой) + ItemID.
+	 * Одинаков между запусками и машинами, в отличие от адреса ассета и индексов FName.
+	 */
+	FORCEINLINE uint64 GetStableHash() const { EnsureCompatibilityMasks(); return StableHash; }
+
+	/** Пересчитать маски из конфигов (после загрузки / правки в редакторе). */
+	void RebuildCompatibilityMasks() const;
+
+private:
+	/** Ассет, созданный в рантайме (NewObject), PostLoad не получает — маски строим при первом запросе */
+	FORCEINLINE void EnsureCompatibilityMasks() const
+	{
+		if (!bCompatibilityMasksBuilt)
+		{
+			RebuildCompatibilityMasks();
+		}
+	}
+
+	mutable uint64 CompatibleAmmoMask = 0;
+	mutable uint64 CompatibleMagazineMask = 0;
+	mutable uint32 EquipSlotMask = 0;
+	mutable FItemTagBits ItemTagBits;
+	mutable FCompiledItemFilter HelmetFilter;
+	mutable FCompiledItemFilter BackpackFilter;
+	mutable uint64 StableHash = 0;
+	mutable bool bCompatibilityMasksBuilt = false;
 };
\ No newline at end of file
@@ -83,6 +83,8 @@ enum class EItemSubCategory : uint8
 UENUM(BlueprintType)
 enum class EAmmoType : uint8
 {
+	// Не больше 64 значений: совместимость хранится битовой маской (UMasterItemDataAsset)
+
 	AmmoType_None UMETA(DisplayName="None"),
 
 	AmmoType_45ACP               UMETA(DisplayName=".45 ACP"),
@@ -145,6 +147,8 @@ enum class EGrenadeType : uint8
 UENUM(BlueprintType)
 enum class EMagazineType : uint8
 {
+	// Не больше 64 значений: совместимость хранится битовой маской (UMasterItemDataAsset)
+
 	Mag_None      UMETA(DisplayName="None"),
 
 	// ItemCat_Attachments -> ItemSubCat_Attachments_Magazine
@@ -5,6 +5,7 @@
 #include "Items/MasterItemStructs.h"
 #include "Blueprint/DragDropOperation.h"
 #include "Input/Reply.h"
+#include "Components/InventoryComponent.h"
 #include "InventoryGridWidget.generated.h"
 
 class UInventoryItemWidget;
@@ -78,6 +79,17 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Drag")
 	int32 DraggedItemTopLeftTileY = 0;
 
+	// Притягивать подсветку к ближайшему месту, куда предмет влезает (не дальше DropSnapRadius клеток)
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Drag")
+	bool bSnapToNearestValid = true;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Drag", meta=(ClampMin="0", UIMin="0"))
+	int32 DropSnapRadius = 1;
+
+	// Предмет влезает в текущий TopLeft (по маске drag'а)
+	UPROPERTY(BlueprintReadOnly, Category="Drag")
+	bool bDropLocationValid = false;
+
 	// Линии сетки (для отрисовки)
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category="Grid")
 	TArray<FLine2D> Lines;
@@ -122,7 +134,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Grid")
 	void CreateLineSegments();
 
-	/** Initialize: сохранить ссылки, выставить TileSize, линии, Refresh, подписка на OnInventoryChanged */
+	/** Initialize: сохранить ссылки, выставить TileSize, линии, Refresh, подписка на OnInventoryDelta */
 	UFUNCTION(BlueprintCallable, Category="Grid")
 	void InitializeGrid(UInventoryComponent* InInventoryComponent, float InTileSize = 64.f, UInventoryWidget* InWBInventory = nullptr);
 
@@ -130,7 +142,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Grid")
 	void Refresh();
 
-	/** Утилита для макроса ForEachItem: найти TopLeftTile предмета (по первой ячейке в массиве Items) */
+	/** Патч по дельте инвентаря: трогаем только виджеты измененных предметов */
+	UFUNCTION()
+	void HandleInventoryDelta(const FInventoryDelta& Delta);
+
+	/** Утилита для макроса ForEachItem: найти TopLeftTile предмета (по таблице размещений инвентаря) */
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category="Grid")
 	bool GetTopLeftTileForItem(UItemObject* ItemObject, FTile& OutTile) const;
 
@@ -138,6 +154,35 @@ public:
 	void GetItemTileMap(TMap<UItemObject*, FTile>& OutMap) const;
 
 protected:
+	/** Создать виджет предмета и положить его на CanvasPanel в Tile */
+	UInventoryItemWidget* CreateItemWidget(UItemObject* Item, const FTile& Tile);
+
+	/** Перенос внутри этого же инвентаря (старые клетки предмета считаются свободными). */
+	bool IsMoveWithinGrid(const UDragDropOperation* Operation) const;
+
+	/** Маска построена под этот предмет/ориентацию/операцию и текущее содержимое грида. */
+	bool IsDropMaskCurrent(const UItemObject* Item, const UDragDropOperation* Operation) const;
+
+	/** Пересобрать DropMask, если она устарела. true — пересобрана. */
+	bool UpdateDropMask(UItemObject* Item, const UDragDropOperation* Operation);
+
+	/** Допустимые TopLeft перетаскиваемого предмета (строится один раз на drag, см. UpdateDropMask) */
+	FInventoryPlacementMask DropMask;
+	TWeakObjectPtr<const UItemObject> DropMaskItem;
+	uint64 DropMaskContentHash = 0;
+	bool bDropMaskIgnoresOwnCells = false;
+
+	/** Подсветить все предметы грида, на которые можно применить Payload (патроны/магазины). */
+	void HighlightApplyTargets(const UItemObject* Payload);
+	void ClearApplyTargetHighlights();
+
+	/** Подсвеченные сейчас цели применения */
+	TArray<TWeakObjectPtr<UInventoryItemWidget>> ApplyTargetWidgets;
+
+	/** Виджеты на CanvasPanel по предмету (для патча по дельте) */
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UItemObject>, TObjectPtr<UInventoryItemWidget>> ItemWidgets;
+
 	virtual void NativePreConstruct() override;
 	virtual void NativeConstruct() override;
 
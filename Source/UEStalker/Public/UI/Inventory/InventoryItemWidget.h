@@ -54,6 +54,10 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="UI")
 	float TileSize = 64.f;
 
+	/** Цвет бордера, пока на предмет можно применить перетаскиваемый (патроны -> магазин и т.п.) */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="UI")
+	FLinearColor ApplyTargetColor = FLinearColor(0.35f, 1.f, 0.35f, 0.8f);
+
 	// ===== Events (Call On Use Selected Item / Call On Delete Selected Item) =====
 	UPROPERTY(BlueprintAssignable, Category="Item|Events")
 	FOnUseSelectedItem OnUseSelectedItem;
@@ -74,6 +78,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Item")
 	void Refresh();
 
+	/** Подсветка цели применения на время drag (ставит InventoryGridWidget). */
+	UFUNCTION(BlueprintCallable, Category="Item")
+	void SetApplyTargetHighlight(bool bHighlighted);
+
+	UFUNCTION(BlueprintPure, Category="Item")
+	bool IsApplyTargetHighlighted() const { return bApplyTargetHighlighted; }
+
 protected:
 	virtual void NativeConstruct() override;
 	virtual void NativeOnInitialized() override;
@@ -115,6 +126,11 @@ protected:
 	virtual void NativeOnMouseLeave(const FPointerEvent& InMouseEvent) override;
 
 private:
+	bool bApplyTargetHighlighted = false;
+
+	/** Цвет бордера без hover */
+	FLinearColor GetIdleBorderColor() const;
+
 	void ApplySizeFromItem();
 	void RefreshCountVisual();
 
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
 #include "Components/EquipmentComponent.h"
+#include "Components/InventoryComponent.h"
 #include "InventorySlotWidget.generated.h"
 
 class USizeBox;
@@ -133,7 +134,7 @@ private:
 	static float CalcDurability(const UItemObject* Item);
 
 	UFUNCTION()
-	void HandleInventoryChanged();
+	void HandleInventoryDelta(const FInventoryDelta& Delta);
 
 	// чтобы слот не перекрывал другие drop-target'ы во время перетаскивания
 	ESlateVisibility CachedVisibility = ESlateVisibility::Visible;
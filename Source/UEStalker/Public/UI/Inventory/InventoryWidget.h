@@ -13,6 +13,7 @@ class UEquipmentComponent;
 class UInventoryGridWidget;
 class UDropAreaWidget;
 class UItemObject;
+struct FEquipmentChangeSet;
 
 UCLASS()
 class UESTALKER_API UInventoryWidget : public UUserWidget
@@ -125,6 +126,7 @@ public:
 
 protected:
 	virtual void NativeOnInitialized() override;
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
 	
 	// OnDrop
 	virtual bool NativeOnDrop(
@@ -137,8 +139,18 @@ private:
 	bool bRuntimeInitialized = false;
 	void SetupWithInventory();
 
-	UFUNCTION()
-	void OnEquipmentSlotChanged(EEquipmentSlotId SlotId, UItemObject* Item);
+	/** Один вызов на операцию экипировки (FEquipmentChangeSet) */
+	void OnEquipmentChanged(const FEquipmentChangeSet& ChangeSet);
+
+	/** Инвентарь/экипировка поменялись — обновить панель не чаще раза в кадр (флаг сбрасывает NativeTick). */
+	void RequestPanelRefresh();
+	void FlushPanelRefresh();
+
+	bool bPanelRefreshPending = false;
+
+	// Последние показанные значения (не трогаем текст, если ничего не поменялось)
+	float ShownWeight = -1.f;
+	float ShownMaxWeight = -1.f;
 
 public:
 	// HandleBorderMouseDown